@@ -0,0 +1,322 @@
+#include "cigsoftware.h"
+#include <string.h>
+
+#if !defined(CIG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define SW_SIMD_SSE2
+  #include <emmintrin.h>
+#elif !defined(CIG_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+  #define SW_SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
+#define GLYPH_W 6
+#define GLYPH_H 8
+
+/*  Classic 5x7 ASCII font, codepoints 32 to 126 */
+static const unsigned char ascii_glyphs[95][5] = {
+  { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 }, /*   ! */
+  { 0x00, 0x07, 0x00, 0x07, 0x00 }, { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, /* " # */
+  { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 }, /* $ % */
+  { 0x36, 0x49, 0x55, 0x22, 0x50 }, { 0x00, 0x05, 0x03, 0x00, 0x00 }, /* & ' */
+  { 0x00, 0x1C, 0x22, 0x41, 0x00 }, { 0x00, 0x41, 0x22, 0x1C, 0x00 }, /* ( ) */
+  { 0x08, 0x2A, 0x1C, 0x2A, 0x08 }, { 0x08, 0x08, 0x3E, 0x08, 0x08 }, /* * + */
+  { 0x00, 0x50, 0x30, 0x00, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, /* , - */
+  { 0x00, 0x60, 0x60, 0x00, 0x00 }, { 0x20, 0x10, 0x08, 0x04, 0x02 }, /* . / */
+  { 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 }, /* 0 1 */
+  { 0x42, 0x61, 0x51, 0x49, 0x46 }, { 0x21, 0x41, 0x45, 0x4B, 0x31 }, /* 2 3 */
+  { 0x18, 0x14, 0x12, 0x7F, 0x10 }, { 0x27, 0x45, 0x45, 0x45, 0x39 }, /* 4 5 */
+  { 0x3C, 0x4A, 0x49, 0x49, 0x30 }, { 0x01, 0x71, 0x09, 0x05, 0x03 }, /* 6 7 */
+  { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x06, 0x49, 0x49, 0x29, 0x1E }, /* 8 9 */
+  { 0x00, 0x36, 0x36, 0x00, 0x00 }, { 0x00, 0x56, 0x36, 0x00, 0x00 }, /* : ; */
+  { 0x08, 0x14, 0x22, 0x41, 0x00 }, { 0x14, 0x14, 0x14, 0x14, 0x14 }, /* < = */
+  { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x51, 0x09, 0x06 }, /* > ? */
+  { 0x32, 0x49, 0x79, 0x41, 0x3E }, { 0x7E, 0x11, 0x11, 0x11, 0x7E }, /* @ A */
+  { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 }, /* B C */
+  { 0x7F, 0x41, 0x41, 0x22, 0x1C }, { 0x7F, 0x49, 0x49, 0x49, 0x41 }, /* D E */
+  { 0x7F, 0x09, 0x09, 0x01, 0x01 }, { 0x3E, 0x41, 0x41, 0x51, 0x32 }, /* F G */
+  { 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 }, /* H I */
+  { 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 }, /* J K */
+  { 0x7F, 0x40, 0x40, 0x40, 0x40 }, { 0x7F, 0x02, 0x04, 0x02, 0x7F }, /* L M */
+  { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E }, /* N O */
+  { 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E }, /* P Q */
+  { 0x7F, 0x09, 0x19, 0x29, 0x46 }, { 0x46, 0x49, 0x49, 0x49, 0x31 }, /* R S */
+  { 0x01, 0x01, 0x7F, 0x01, 0x01 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F }, /* T U */
+  { 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x7F, 0x20, 0x18, 0x20, 0x7F }, /* V W */
+  { 0x63, 0x14, 0x08, 0x14, 0x63 }, { 0x03, 0x04, 0x78, 0x04, 0x03 }, /* X Y */
+  { 0x61, 0x51, 0x49, 0x45, 0x43 }, { 0x00, 0x00, 0x7F, 0x41, 0x41 }, /* Z [ */
+  { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x41, 0x41, 0x7F, 0x00, 0x00 }, /* \ ] */
+  { 0x04, 0x02, 0x01, 0x02, 0x04 }, { 0x40, 0x40, 0x40, 0x40, 0x40 }, /* ^ _ */
+  { 0x00, 0x01, 0x02, 0x04, 0x00 }, { 0x20, 0x54, 0x54, 0x54, 0x78 }, /* ` a */
+  { 0x7F, 0x48, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x20 }, /* b c */
+  { 0x38, 0x44, 0x44, 0x48, 0x7F }, { 0x38, 0x54, 0x54, 0x54, 0x18 }, /* d e */
+  { 0x08, 0x7E, 0x09, 0x01, 0x02 }, { 0x08, 0x14, 0x54, 0x54, 0x3C }, /* f g */
+  { 0x7F, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7D, 0x40, 0x00 }, /* h i */
+  { 0x20, 0x40, 0x44, 0x3D, 0x00 }, { 0x00, 0x7F, 0x10, 0x28, 0x44 }, /* j k */
+  { 0x00, 0x41, 0x7F, 0x40, 0x00 }, { 0x7C, 0x04, 0x18, 0x04, 0x78 }, /* l m */
+  { 0x7C, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 }, /* n o */
+  { 0x7C, 0x14, 0x14, 0x14, 0x08 }, { 0x08, 0x14, 0x14, 0x18, 0x7C }, /* p q */
+  { 0x7C, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x20 }, /* r s */
+  { 0x04, 0x3F, 0x44, 0x40, 0x20 }, { 0x3C, 0x40, 0x40, 0x20, 0x7C }, /* t u */
+  { 0x1C, 0x20, 0x40, 0x20, 0x1C }, { 0x3C, 0x40, 0x30, 0x40, 0x3C }, /* v w */
+  { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x0C, 0x50, 0x50, 0x50, 0x3C }, /* x y */
+  { 0x44, 0x64, 0x54, 0x4C, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 }, /* z { */
+  { 0x00, 0x00, 0x7F, 0x00, 0x00 }, { 0x00, 0x41, 0x36, 0x08, 0x00 }, /* | } */
+  { 0x02, 0x01, 0x02, 0x04, 0x02 }                                    /* ~   */
+};
+
+static const cig_sw_font default_font = {
+  .glyphs = ascii_glyphs,
+  .first = 32,
+  .count = 95,
+  .scale = 1
+};
+
+/*  ┌─────────┐
+    │ DRAWING │
+    └─────────┘ */
+
+/*  Every fill ends up here, so this is the one place worth vectorizing */
+M_INLINED void fill_span(uint32_t *dst, size_t n, uint32_t color) {
+  size_t i = 0;
+#if defined(SW_SIMD_SSE2)
+  const __m128i c = _mm_set1_epi32((int)color);
+  for (; i + 8 <= n; i += 8) {
+    _mm_storeu_si128((__m128i*)(dst + i), c);
+    _mm_storeu_si128((__m128i*)(dst + i + 4), c);
+  }
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_si128((__m128i*)(dst + i), c);
+  }
+#elif defined(SW_SIMD_NEON)
+  const uint32x4_t c = vdupq_n_u32(color);
+  for (; i + 4 <= n; i += 4) {
+    vst1q_u32(dst + i, c);
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = color;
+  }
+}
+
+M_INLINED uint32_t blend(uint32_t dst, uint32_t src) {
+  const uint32_t a = src >> 24, ia = 255 - a;
+  const uint32_t rb = (((src & 0x00FF00FF) * a + (dst & 0x00FF00FF) * ia) >> 8) & 0x00FF00FF;
+  const uint32_t g = ((((src >> 8) & 0xFF) * a + ((dst >> 8) & 0xFF) * ia) >> 8) & 0xFF;
+  return rb | (g << 8) | 0xFF000000;
+}
+
+void cig_sw_framebuffer_init(cig_sw_framebuffer *fb, uint32_t *pixels, int w, int h) {
+  *fb = (cig_sw_framebuffer) {
+    .pixels = pixels,
+    .w = w,
+    .h = h,
+    .stride = w,
+    .clip = cig_r_make(0, 0, w, h)
+  };
+}
+
+void cig_sw_clear(cig_sw_framebuffer *fb, uint32_t color) {
+  int y;
+
+  if (fb->stride == fb->w) {
+    fill_span(fb->pixels, (size_t)fb->w * fb->h, color);
+    return;
+  }
+
+  for (y = 0; y < fb->h; ++y) {
+    fill_span(fb->pixels + (size_t)y * fb->stride, fb->w, color);
+  }
+}
+
+void cig_sw_fill_rect(cig_sw_framebuffer *fb, cig_r rect, uint32_t color) {
+  int y;
+  const cig_r r = cig_r_union(fb->clip, rect);
+
+  if (r.w <= 0 || r.h <= 0) {
+    return;
+  }
+
+  for (y = r.y; y < r.y + r.h; ++y) {
+    fill_span(fb->pixels + (size_t)y * fb->stride + r.x, r.w, color);
+  }
+}
+
+static void draw_glyph(cig_sw_framebuffer *fb, int x, int y, const unsigned char *glyph, int scale, uint32_t color) {
+  int col, row;
+  const cig_r clip = fb->clip;
+
+  /*  Whole cell is clipped */
+  if (x >= clip.x + clip.w || y >= clip.y + clip.h || x + GLYPH_W * scale <= clip.x || y + GLYPH_H * scale <= clip.y) {
+    return;
+  }
+
+  if (scale > 1) {
+    for (col = 0; col < 5; ++col) {
+      unsigned char bits = glyph[col];
+      for (row = 0; bits; ++row, bits >>= 1) {
+        if (bits & 1) {
+          cig_sw_fill_rect(fb, cig_r_make(x + col * scale, y + row * scale, scale, scale), color);
+        }
+      }
+    }
+    return;
+  }
+
+  /*  Unscaled glyphs are plotted directly, clipping each pixel */
+  for (col = 0; col < 5; ++col) {
+    const int px = x + col;
+    unsigned char bits = glyph[col];
+
+    if (px < clip.x || px >= clip.x + clip.w) {
+      continue;
+    }
+
+    for (row = 0; bits; ++row, bits >>= 1) {
+      const int py = y + row;
+      if ((bits & 1) && py >= clip.y && py < clip.y + clip.h) {
+        fb->pixels[(size_t)py * fb->stride + px] = color;
+      }
+    }
+  }
+}
+
+void cig_sw_draw_text(
+  cig_sw_framebuffer *fb,
+  cig_v position,
+  const cig_sw_font *font,
+  uint32_t color,
+  const char *str,
+  size_t len
+) {
+  size_t i;
+  int x = position.x;
+
+  for (i = 0; i < len; ++i) {
+    const unsigned char ch = (unsigned char)str[i];
+
+    /*  UTF-8 continuation bytes don't start a new character */
+    if ((ch & 0xC0) == 0x80) {
+      continue;
+    }
+
+    const unsigned char *glyph = (ch >= font->first && ch < font->first + font->count)
+      ? font->glyphs[ch - font->first]
+      : font->glyphs['?' - font->first];
+
+    draw_glyph(fb, x, position.y, glyph, font->scale, color);
+    x += GLYPH_W * font->scale;
+  }
+}
+
+uint32_t cig_sw_hash(const cig_sw_framebuffer *fb) {
+  int x, y;
+  uint32_t hash = 2166136261u;
+
+  for (y = 0; y < fb->h; ++y) {
+    const unsigned char *row = (const unsigned char*)(fb->pixels + (size_t)y * fb->stride);
+    for (x = 0; x < fb->w * 4; ++x) {
+      hash = (hash ^ row[x]) * 16777619u;
+    }
+  }
+
+  return hash;
+}
+
+/*  ┌───────────────────┐
+    │ BACKEND CALLBACKS │
+    └───────────────────┘ */
+
+cig_sw_font cig_sw_default_font(unsigned char scale) {
+  cig_sw_font font = default_font;
+  font.scale = scale ? scale : 1;
+  return font;
+}
+
+M_INLINED const cig_sw_font* font_or_default(cig_font_ref font_ref) {
+  return font_ref ? (const cig_sw_font*)font_ref : &default_font;
+}
+
+static void set_clip(cig_buffer_ref buffer, cig_r rect, bool reset) {
+  cig_sw_framebuffer *fb = (cig_sw_framebuffer*)buffer;
+  const cig_r bounds = cig_r_make(0, 0, fb->w, fb->h);
+  fb->clip = reset ? bounds : cig_r_union(bounds, rect);
+}
+
+static void draw_text(
+  const char *str,
+  size_t len,
+  cig_r rect,
+  cig_font_ref font,
+  cig_text_color_ref color,
+  cig_text_style style
+) {
+  cig_sw_draw_text(
+    (cig_sw_framebuffer*)cig_buffer(),
+    cig_v_make(rect.x, rect.y),
+    font_or_default(font),
+    color ? *(const uint32_t*)color : CIG_SW_RGBA(0, 0, 0, 255),
+    str,
+    len
+  );
+}
+
+static cig_v measure_text(const char *str, size_t len, cig_font_ref font, cig_text_style style) {
+  size_t i, count = 0;
+  const cig_sw_font *f = font_or_default(font);
+
+  for (i = 0; i < len; ++i) {
+    count += ((unsigned char)str[i] & 0xC0) != 0x80;
+  }
+
+  return cig_v_make(count * GLYPH_W * f->scale, GLYPH_H * f->scale);
+}
+
+static cig_font_info_st query_font(cig_font_ref font) {
+  return (cig_font_info_st) {
+    .height = GLYPH_H * font_or_default(font)->scale,
+    .baseline_offset = 0,
+    .cache_advances = true
+  };
+}
+
+static cig_v measure_image(cig_image_ref image) {
+  const cig_sw_image *img = (const cig_sw_image*)image;
+  return cig_v_make(img->w, img->h);
+}
+
+/*  Nearest neighbour scaling, source-over blending for translucent pixels */
+static void draw_image(cig_buffer_ref buffer, cig_r container, cig_r rect, cig_image_ref image, cig_image_mode mode) {
+  int x, y;
+  cig_sw_framebuffer *fb = (cig_sw_framebuffer*)buffer;
+  const cig_sw_image *img = (const cig_sw_image*)image;
+  const cig_r r = cig_r_union(fb->clip, rect);
+
+  if (r.w <= 0 || r.h <= 0 || img->w <= 0 || img->h <= 0) {
+    return;
+  }
+
+  for (y = r.y; y < r.y + r.h; ++y) {
+    const uint32_t *src = img->pixels + (size_t)((y - rect.y) * img->h / rect.h) * img->w;
+    uint32_t *dst = fb->pixels + (size_t)y * fb->stride;
+
+    for (x = r.x; x < r.x + r.w; ++x) {
+      const uint32_t pixel = src[(x - rect.x) * img->w / rect.w];
+      const uint32_t alpha = pixel >> 24;
+
+      if (alpha == 255) {
+        dst[x] = pixel;
+      } else if (alpha) {
+        dst[x] = blend(dst[x], pixel);
+      }
+    }
+  }
+}
+
+void cig_sw_assign_callbacks(void) {
+  cig_assign_set_clip(&set_clip);
+  cig_assign_draw_text(&draw_text);
+  cig_assign_measure_text(&measure_text);
+  cig_assign_query_font(&query_font);
+  cig_assign_measure_image(&measure_image);
+  cig_assign_draw_image(&draw_image);
+}
@@ -0,0 +1,75 @@
+#ifndef CIG_SOFTWARE_INCLUDED
+#define CIG_SOFTWARE_INCLUDED
+
+#include "cigcore.h"
+#include "cigtext.h"
+#include "cigimage.h"
+
+/*  ╔═══════════════════════════════════════════════╗
+    ║ CIG SOFTWARE BACKEND                          ║
+    ║                                               ║
+    ║ Reference CPU renderer that draws into an     ║
+    ║ in-memory RGBA framebuffer. Deterministic and ║
+    ║ GPU-free, for benchmarks and screenshot tests ║
+    ╚═══════════════════════════════════════════════╝ */
+
+/*  Pixels are stored as R, G, B, A bytes in memory */
+#define CIG_SW_RGBA(R, G, B, A) \
+  ((uint32_t)(R) | ((uint32_t)(G) << 8) | ((uint32_t)(B) << 16) | ((uint32_t)(A) << 24))
+
+/*  Framebuffer is also the buffer reference passed to `cig_begin_layout`
+    and `cig_push_buffer` */
+typedef struct {
+  uint32_t *pixels;
+  int w, h,
+      stride;                   /* Pixels per row */
+  cig_r clip;                   /* Current clip rect, always within the bounds */
+} cig_sw_framebuffer;
+
+/*  Fixed width bitmap font. Glyphs are 5x7 pixels, column-major with the
+    least significant bit on top, in a 6x8 cell. Scale multiplies both */
+typedef struct {
+  const unsigned char (*glyphs)[5];
+  unsigned char first,          /* First codepoint in `glyphs` */
+                count;
+  unsigned char scale;
+} cig_sw_font;
+
+/*  Images use the same pixel format as the framebuffer */
+typedef struct {
+  const uint32_t *pixels;
+  int w, h;
+} cig_sw_image;
+
+/*  ┌─────────────┐
+    │ FRAMEBUFFER │
+    └─────────────┘ */
+
+void cig_sw_framebuffer_init(cig_sw_framebuffer*, uint32_t *pixels, int w, int h);
+
+/*  Fills the whole framebuffer, ignoring the clip rect */
+void cig_sw_clear(cig_sw_framebuffer*, uint32_t color);
+
+/*  Fills a rect within the current clip rect */
+void cig_sw_fill_rect(cig_sw_framebuffer*, cig_r, uint32_t color);
+
+/*  Draws a string with the bitmap font. Characters outside the font are
+    drawn as '?'. Text color reference is a pointer to an RGBA value */
+void cig_sw_draw_text(cig_sw_framebuffer*, cig_v, const cig_sw_font*, uint32_t color, const char *, size_t);
+
+/*  FNV-1a hash of the visible pixels, for comparing screenshots */
+uint32_t cig_sw_hash(const cig_sw_framebuffer*);
+
+/*  ┌─────────┐
+    │ BACKEND │
+    └─────────┘ */
+
+/*  Built-in ASCII font at the given integer scale */
+cig_sw_font cig_sw_default_font(unsigned char scale);
+
+/*  Assigns text, image and clip callbacks. Framebuffer is taken from
+    `cig_buffer()`, fonts are `cig_sw_font*` (NULL for the default font at
+    scale 1), text colors are `uint32_t*` and images `cig_sw_image*` */
+void cig_sw_assign_callbacks(void);
+
+#endif
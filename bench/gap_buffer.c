@@ -0,0 +1,119 @@
+#include "types/gap_buffer.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*  Gap buffer microbenchmark: appending a large text with and without a
+    reserve, and edits at random or nearby positions in a large buffer.
+    Prints one line per workload, nanoseconds per operation and how many
+    times the buffer was (re)allocated */
+
+#define APPEND_BYTES (16 << 20)
+#define LINE_BYTES 64
+#define EDIT_BUFFER_BYTES (4 << 20)
+#define EDITS 20000
+
+static size_t alloc_calls;
+static char line[LINE_BYTES];
+static volatile size_t sink;
+
+static void* bench_alloc(void *ud, size_t size, size_t align) {
+  alloc_calls++;
+  return malloc(size);
+}
+
+static void* bench_realloc(void *ud, void *ptr, size_t old_size, size_t new_size) {
+  alloc_calls++;
+  return realloc(ptr, new_size);
+}
+
+static void bench_free(void *ud, void *ptr) {
+  free(ptr);
+}
+
+static cig_allocator allocator = { bench_alloc, bench_realloc, bench_free };
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char *name, double start, double end, size_t ops) {
+  printf("%-24s %10.1f ns/op %6zu allocs\n", name, (end - start) / ops, alloc_calls);
+}
+
+static void append(const char *name, bool reserve) {
+  gap_buffer_char *buffer;
+  size_t i;
+  double t0;
+
+  alloc_calls = 0;
+  t0 = now_ns();
+
+  gap_buffer_char_new(&buffer, &allocator, 0, 0);
+  if (reserve) {
+    gap_buffer_char_reserve(&buffer, APPEND_BYTES);
+  }
+  for (i = 0; i < APPEND_BYTES / LINE_BYTES; ++i) {
+    gap_buffer_char_insert(&buffer, GAPTAIL, LINE_BYTES, line);
+  }
+
+  report(name, t0, now_ns(), APPEND_BYTES / LINE_BYTES);
+  sink = gap_buffer_char_length(buffer);
+  gap_buffer_char_free(&buffer);
+}
+
+/*  Edits at random positions move the gap across the buffer each time, edits
+    within `spread` of the last one are typing and deleting around a caret */
+static void edit(const char *name, size_t spread) {
+  gap_buffer_char *buffer;
+  size_t i, position = EDIT_BUFFER_BYTES / 2;
+  double t0;
+
+  gap_buffer_char_new(&buffer, &allocator, 0, 0);
+  gap_buffer_char_reserve(&buffer, EDIT_BUFFER_BYTES);
+  for (i = 0; i < EDIT_BUFFER_BYTES / LINE_BYTES; ++i) {
+    gap_buffer_char_insert(&buffer, GAPTAIL, LINE_BYTES, line);
+  }
+
+  srand(1);
+  alloc_calls = 0;
+  t0 = now_ns();
+
+  for (i = 0; i < EDITS; ++i) {
+    const size_t length = gap_buffer_char_length(buffer);
+
+    position = spread
+      ? M_MIN(length - 8, (position + length + rand() % (2 * spread + 1) - spread) % length)
+      : rand() % (length - 8);
+
+    if (i & 1) {
+      gap_buffer_char_delete(&buffer, position, 4);
+    } else {
+      gap_buffer_char_insert(&buffer, position, 4, "abcd");
+    }
+  }
+
+  report(name, t0, now_ns(), EDITS);
+  sink = gap_buffer_char_length(buffer);
+  gap_buffer_char_free(&buffer);
+}
+
+int main(int argc, char **argv) {
+  size_t i;
+
+  for (i = 0; i < LINE_BYTES; ++i) {
+    line[i] = i == LINE_BYTES - 1 ? '\n' : 'a' + i % 26;
+  }
+
+  printf("gap buffer, %d MB appended in %d byte lines, %d edits in %d MB\n", APPEND_BYTES >> 20, LINE_BYTES, EDITS, EDIT_BUFFER_BYTES >> 20);
+
+  append("append", false);
+  append("append (reserved)", true);
+  edit("edit (random)", 0);
+  edit("edit (near caret)", 64);
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include "types/gap_buffer.h"
+#include "types/piece_table.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*  Piece table microbenchmark against the gap buffer: loading a large file,
+    edits at random positions, and reading the whole text back. The piece
+    table maps the file instead of reading it in, and its edits don't move
+    text, but reading goes through more, shorter runs as edits pile up */
+
+#define FILE_BYTES (64 << 20)
+#define LINE_BYTES 64
+#define EDITS 20000
+#define PATH "bench_piece_table.txt"
+
+static volatile size_t sink;
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char *name, double start, double end, size_t ops) {
+  printf("%-28s %14.1f ns/op\n", name, (end - start) / ops);
+}
+
+static void write_file() {
+  char line[LINE_BYTES];
+  FILE *file = fopen(PATH, "wb");
+  size_t i;
+
+  for (i = 0; i < LINE_BYTES; ++i) {
+    line[i] = i == LINE_BYTES - 1 ? '\n' : 'a' + i % 26;
+  }
+  for (i = 0; i < FILE_BYTES / LINE_BYTES; ++i) {
+    fwrite(line, 1, LINE_BYTES, file);
+  }
+
+  fclose(file);
+}
+
+static gap_buffer_char* load_gap_buffer() {
+  gap_buffer_char *buffer;
+  FILE *file = fopen(PATH, "rb");
+
+  gap_buffer_char_new(&buffer, NULL, 0, FILE_BYTES);
+  sink = fread(buffer->buffer, 1, FILE_BYTES, file);
+  buffer->gap.start = FILE_BYTES;
+  buffer->gap.size = 0;
+  fclose(file);
+
+  return buffer;
+}
+
+/*  Sums the text so every page is actually read */
+static size_t checksum(const char *str, size_t length) {
+  size_t i, sum = 0;
+
+  for (i = 0; i < length; i += 64) {
+    sum += str[i];
+  }
+
+  return sum;
+}
+
+int main(int argc, char **argv) {
+  gap_buffer_char *buffer;
+  piece_table_char table;
+  piece_table_char_iterator iter;
+  const char *str;
+  size_t i, length, sum;
+  double t0;
+
+  write_file();
+  printf("piece table vs gap buffer, %d MB file, %d edits\n", FILE_BYTES >> 20, EDITS);
+
+  t0 = now_ns();
+  buffer = load_gap_buffer();
+  report("gap buffer load", t0, now_ns(), 1);
+
+  t0 = now_ns();
+  if (!piece_table_char_open(&table, NULL, PATH)) {
+    fprintf(stderr, "Can't open %s\n", PATH);
+    return 1;
+  }
+  report("piece table open", t0, now_ns(), 1);
+
+  srand(1);
+  t0 = now_ns();
+  for (i = 0; i < EDITS; ++i) {
+    const size_t position = rand() % (gap_buffer_char_length(buffer) - 8);
+    if (i & 1) {
+      gap_buffer_char_delete(&buffer, position, 4);
+    } else {
+      gap_buffer_char_insert(&buffer, position, 4, "abcd");
+    }
+  }
+  report("gap buffer edit (random)", t0, now_ns(), EDITS);
+
+  srand(1);
+  t0 = now_ns();
+  for (i = 0; i < EDITS; ++i) {
+    const size_t position = rand() % (piece_table_char_length(&table) - 8);
+    if (i & 1) {
+      piece_table_char_delete(&table, position, 4);
+    } else {
+      piece_table_char_insert(&table, position, 4, "abcd");
+    }
+  }
+  report("piece table edit (random)", t0, now_ns(), EDITS);
+
+  t0 = now_ns();
+  gap_buffer_char_place_gap(&buffer, GAPTAIL);
+  sum = checksum(buffer->buffer, gap_buffer_char_length(buffer));
+  report("gap buffer read", t0, now_ns(), 1);
+
+  t0 = now_ns();
+  iter = piece_table_char_iterate(&table, 0, piece_table_char_length(&table));
+  while (piece_table_char_next(&iter, &str, &length)) {
+    sum += checksum(str, length);
+  }
+  report("piece table read", t0, now_ns(), 1);
+  printf("%zu pieces\n", table.piece_count);
+
+  sink = sum;
+  gap_buffer_char_free(&buffer);
+  piece_table_char_free(&table);
+  remove(PATH);
+
+  return 0;
+}
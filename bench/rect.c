@@ -0,0 +1,85 @@
+#include "cigcore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*  Rect kernel microbenchmark: scalar versus vectorized versions from
+    `types/rect_simd.h`. Prints one line per kernel, nanoseconds per rect */
+
+#define RECT_COUNT 4096
+#define ROUNDS 2000
+
+static cig_r rects[RECT_COUNT];
+static bool hits[RECT_COUNT];
+static volatile int64_t sink;
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char *name, double start, double end) {
+  printf("%-24s %8.3f ns/rect\n", name, (end - start) / ((double)RECT_COUNT * ROUNDS));
+}
+
+int main(int argc, char **argv) {
+  int i, r;
+  int64_t acc;
+  double t0;
+
+  const cig_r bounds = cig_r_make(0, 0, 640, 480);
+
+  srand(1);
+
+  for (i = 0; i < RECT_COUNT; ++i) {
+    rects[i] = cig_r_make(rand() % 1600 - 480, rand() % 1200 - 360, rand() % 200, rand() % 200);
+  }
+
+  printf("rect kernels, %d rects x %d rounds\n", RECT_COUNT, ROUNDS);
+
+  acc = 0; t0 = now_ns();
+  for (r = 0; r < ROUNDS; ++r) {
+    for (i = 0; i < RECT_COUNT; ++i) { acc += cig_r_intersects(rects[i], bounds); }
+  }
+  report("intersects (scalar)", t0, now_ns()); sink = acc;
+
+  acc = 0; t0 = now_ns();
+  for (r = 0; r < ROUNDS; ++r) {
+    for (i = 0; i < RECT_COUNT; ++i) { acc += cig_r_intersects_simd(rects[i], bounds); }
+  }
+  report("intersects (simd)", t0, now_ns()); sink = acc;
+
+  acc = 0; t0 = now_ns();
+  for (r = 0; r < ROUNDS; ++r) {
+    cig_r_intersects_n(bounds, rects, RECT_COUNT, hits);
+    acc += hits[r % RECT_COUNT];
+  }
+  report("intersects_n (batch)", t0, now_ns()); sink = acc;
+
+  acc = 0; t0 = now_ns();
+  for (r = 0; r < ROUNDS; ++r) {
+    for (i = 0; i < RECT_COUNT; ++i) { acc += cig_r_union(rects[i], bounds).w; }
+  }
+  report("union (scalar)", t0, now_ns()); sink = acc;
+
+  acc = 0; t0 = now_ns();
+  for (r = 0; r < ROUNDS; ++r) {
+    for (i = 0; i < RECT_COUNT; ++i) { acc += cig_r_union_simd(rects[i], bounds).w; }
+  }
+  report("union (simd)", t0, now_ns()); sink = acc;
+
+  acc = 0; t0 = now_ns();
+  for (r = 0; r < ROUNDS; ++r) {
+    for (i = 0; i < RECT_COUNT; ++i) { acc += cig_r_containing(rects[i], bounds).w; }
+  }
+  report("containing (scalar)", t0, now_ns()); sink = acc;
+
+  acc = 0; t0 = now_ns();
+  for (r = 0; r < ROUNDS; ++r) {
+    for (i = 0; i < RECT_COUNT; ++i) { acc += cig_r_containing_simd(rects[i], bounds).w; }
+  }
+  report("containing (simd)", t0, now_ns()); sink = acc;
+
+  return 0;
+}
@@ -0,0 +1,369 @@
+#include "cigcore.h"
+#include "cigtext.h"
+#include "cigtextview.h"
+#include "cigsoftware.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*  Synthetic scene benchmark. Runs the core against a headless stub backend
+    (layout only) and the software raster backend (layout and drawing), and
+    prints one JSON object per scene and backend:
+
+    {"scene":"list_10k","backend":"stub","ticks":500,"ns_per_tick":...,"allocs_per_tick":...,"peak_tracked_bytes":...}
+
+    Usage: bench_scenes [ticks] [scene name filter] */
+
+#define DEFAULT_TICKS 500
+#define SCREEN cig_r_make(0, 0, 640, 480)
+
+static cig_context ctx;
+static uint32_t pixels[640 * 480];
+static cig_sw_framebuffer framebuffer;
+static cig_sw_framebuffer *target;
+static size_t alloc_calls;
+static size_t peak_tracked_bytes;
+static volatile size_t sink;
+
+/*  ┌──────────────┐
+    │ STUB BACKEND │
+    └──────────────┘ */
+
+static void* bench_alloc(void *ud, size_t size, size_t align) {
+  alloc_calls++;
+  return malloc(size);
+}
+
+static void* bench_realloc(void *ud, void *ptr, size_t old_size, size_t new_size) {
+  alloc_calls++;
+  return realloc(ptr, new_size);
+}
+
+static void bench_free(void *ud, void *ptr) {
+  free(ptr);
+}
+
+/*  Fixed width font, same as most terminal fonts at 14px */
+static cig_v measure_text(const char *str, size_t len, cig_font_ref font, cig_text_style style) {
+  return cig_v_make(len * 7, 14);
+}
+
+static void draw_text(const char *str, size_t len, cig_r rect, cig_font_ref font, cig_text_color_ref color, cig_text_style style) {
+  sink += len;
+}
+
+static cig_font_info_st query_font(cig_font_ref font) {
+  return (cig_font_info_st) { .height = 14, .baseline_offset = 0 };
+}
+
+static void set_clip(cig_buffer_ref buffer, cig_r rect, bool reset) {
+  sink += rect.w;
+}
+
+/*  ┌────────┐
+    │ SCENES │
+    └────────┘ */
+
+/*  10k uniform rows in a scrolled, clipped stack. Most rows are culled */
+static void scene_list_10k(int tick) {
+  int i;
+
+  cig_push_vstack(RECT_AUTO, cig_i_zero(), (cig_params) { .height = 20 });
+  cig_enable_scroll(NULL);
+  cig_set_offset(cig_v_make(0, 100000 + (tick % 40) * 5));
+
+  for (i = 0; i < 10000; ++i) {
+    if (cig_push_frame(RECT_AUTO)) {
+      cig_draw_raw_text(cig_v_zero(), CIG_RAW_TEXT_AUTOMATIC_SIZE, NULL, 0, NULL, "List row");
+      cig_pop_frame();
+    }
+  }
+
+  cig_pop_frame();
+}
+
+/*  Nested stacks as deep as the frame stack allows (root and the leaves take
+    one level each), a few leaves on each level */
+static void push_tree_level(int depth) {
+  int i;
+
+  if (!cig_push_vstack(RECT_AUTO, cig_i_make(1, 1, 1, 1), (cig_params) { 0 })) {
+    return;
+  }
+
+  for (i = 0; i < 4; ++i) {
+    if (cig_push_frame(RECT_AUTO_H(3))) {
+      cig_pop_frame();
+    }
+  }
+
+  if (depth > 1) {
+    push_tree_level(depth - 1);
+  }
+
+  cig_pop_frame();
+}
+
+static void scene_tree_32(int tick) {
+  push_tree_level(CIG_NESTED_ELEMENTS_MAX - 2);
+}
+
+/*  64x64 cells, the visible half of them draw text */
+static void scene_grid_64(int tick) {
+  int i;
+
+  cig_push_grid(RECT_AUTO, cig_i_zero(), (cig_params) { .width = 10, .height = 16 });
+  cig_enable_scroll(NULL);
+  cig_set_offset(cig_v_make(0, (tick % 32) * 16));
+
+  for (i = 0; i < 64 * 64; ++i) {
+    if (cig_push_frame(RECT_AUTO)) {
+      cig_draw_raw_text(cig_v_zero(), CIG_RAW_TEXT_AUTOMATIC_SIZE, NULL, 0, NULL, "#");
+      cig_pop_frame();
+    }
+  }
+
+  cig_pop_frame();
+}
+
+static const char *paragraph =
+  "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor "
+  "incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis "
+  "nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. "
+  "Duis aute irure dolor in <b>reprehenderit</b> in voluptate velit esse cillum "
+  "dolore eu fugiat nulla pariatur.";
+
+/*  Wrapped paragraphs. Every 8th tick the width changes so the labels are
+    laid out again instead of being served from the label cache */
+static void scene_text_document(int tick) {
+  int i;
+  const int width = (tick % 8) ? 600 : 560;
+
+  cig_push_vstack(cig_r_make(0, 0, width, CIG_AUTO()), cig_i_zero(), (cig_params) { .spacing = { 0, 8 } });
+
+  for (i = 0; i < 16; ++i) {
+    if (cig_push_frame(RECT_AUTO_H(80))) {
+      cig_draw_label((cig_text_properties) { .flags = CIG_TEXT_FORMATTED }, paragraph);
+      cig_pop_frame();
+    }
+  }
+
+  cig_pop_frame();
+}
+
+/*  Same document drawn through `cig_draw_label_versioned`, unchanged labels
+    skip formatting and hashing */
+static void scene_text_document_versioned(int tick) {
+  int i;
+  const int width = (tick % 8) ? 600 : 560;
+
+  cig_push_vstack(cig_r_make(0, 0, width, CIG_AUTO()), cig_i_zero(), (cig_params) { .spacing = { 0, 8 } });
+
+  for (i = 0; i < 16; ++i) {
+    if (cig_push_frame(RECT_AUTO_H(80))) {
+      cig_draw_label_versioned((cig_text_properties) { .flags = CIG_TEXT_FORMATTED }, 1, paragraph);
+      cig_pop_frame();
+    }
+  }
+
+  cig_pop_frame();
+}
+
+/*  One label of `count` words, laid out again every tick by changing its
+    width by a pixel. Shows parsing throughput and the memory a label keeps */
+static void scene_label_words(int tick, size_t count, char **text) {
+  static const char *words[] = { "lorem", "ipsum", "dolor", "sit", "amet", "elit", "sed", "magna" };
+  size_t i;
+
+  if (!*text) {
+    char *p = *text = malloc(count * 7 + 1);
+    for (i = 0; i < count; ++i) {
+      p += sprintf(p, i ? " %s" : "%s", words[i % 8]);
+    }
+  }
+
+  if (cig_push_frame(cig_r_make(0, 0, 600 + (tick & 1), 480))) {
+    cig_draw_label((cig_text_properties) { .alignment.vertical = CIG_TEXT_ALIGN_TOP }, *text);
+    cig_pop_frame();
+  }
+}
+
+static void scene_label_1_word(int tick) { static char *text; scene_label_words(tick, 1, &text); }
+static void scene_label_100_words(int tick) { static char *text; scene_label_words(tick, 100, &text); }
+static void scene_label_10k_words(int tick) { static char *text; scene_label_words(tick, 10000, &text); }
+
+/*  Log of `lines` lines in a text view, with a character typed in and
+    deleted again on a visible line every tick, or with a jump to another
+    line. Neither should cost more as the log grows */
+static void scene_text_view_log(int tick, size_t lines, bool jump, cig_text_view *view) {
+  char line[96];
+  size_t i;
+
+  if (!view->buffer) {
+    gap_buffer_char *buffer;
+
+    gap_buffer_char_new(&buffer, NULL, 0, lines * 80);
+    for (i = 0; i < lines; ++i) {
+      const int length = snprintf(line, sizeof(line), "%08zu [info] request served in %zu ms, lorem ipsum dolor sit amet\n", i, i % 97);
+      gap_buffer_char_insert(&buffer, GAPTAIL, length, line);
+    }
+    cig_text_view_init(view, buffer);
+  }
+
+  if (jump) {
+    cig_text_view_scroll_to_line(view, (tick * 7919) % lines);
+  } else if (tick & 1) {
+    cig_text_view_insert(view, 200, 1, "x");
+  } else {
+    cig_text_view_delete(view, 200, 1);
+  }
+
+  cig_draw_text_view(view, cig_r_make(0, 0, 600, 480));
+}
+
+static void scene_text_view_log_1k(int tick) { static cig_text_view view; scene_text_view_log(tick, 1000, false, &view); }
+static void scene_text_view_log_50k(int tick) { static cig_text_view view; scene_text_view_log(tick, 50000, false, &view); }
+static void scene_text_view_goto_1k(int tick) { static cig_text_view view; scene_text_view_log(tick, 1000, true, &view); }
+static void scene_text_view_goto_50k(int tick) { static cig_text_view view; scene_text_view_log(tick, 50000, true, &view); }
+
+/*  Retained frames with a bit of state memory each. Every 4th tick one row
+    is skipped, so its state is released and allocated again */
+static void scene_retained(int tick) {
+  int i;
+
+  cig_push_grid(RECT_AUTO, cig_i_zero(), (cig_params) { .width = 16, .height = 16 });
+
+  for (i = 0; i < 1000; ++i) {
+    if ((tick % 4) == 0 && i / 40 == (tick / 4) % 25) {
+      continue;
+    }
+    if (cig_retain(cig_push_frame(RECT_AUTO))) {
+      int *counter = cig_memory_allocate(sizeof(int) * 16);
+      if (counter) { counter[0] += tick; }
+      cig_pop_frame();
+    }
+  }
+
+  cig_pop_frame();
+}
+
+static const struct {
+  const char *name;
+  void (*build)(int);
+} scenes[] = {
+  { "list_10k", &scene_list_10k },
+  { "tree_32", &scene_tree_32 },
+  { "grid_64", &scene_grid_64 },
+  { "text_document", &scene_text_document },
+  { "text_document_versioned", &scene_text_document_versioned },
+  { "label_1_word", &scene_label_1_word },
+  { "label_100_words", &scene_label_100_words },
+  { "label_10k_words", &scene_label_10k_words },
+  { "text_view_log_1k", &scene_text_view_log_1k },
+  { "text_view_log_50k", &scene_text_view_log_50k },
+  { "text_view_goto_1k", &scene_text_view_goto_1k },
+  { "text_view_goto_50k", &scene_text_view_goto_50k },
+  { "retained_1000", &scene_retained }
+};
+
+/*  ┌────────┐
+    │ RUNNER │
+    └────────┘ */
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void tick_scene(void (*build)(int), int tick) {
+  if (target) {
+    cig_sw_clear(target, CIG_SW_RGBA(192, 192, 192, 255));
+  }
+  cig_begin_layout(&ctx, target, SCREEN, 1.f / 60.f);
+  build(tick);
+  cig_end_layout();
+
+  if (ctx.allocator.tracked_bytes > peak_tracked_bytes) {
+    peak_tracked_bytes = ctx.allocator.tracked_bytes;
+  }
+}
+
+static void empty_scene(int tick) {}
+
+static void assign_stub_backend() {
+  cig_assign_measure_text(&measure_text);
+  cig_assign_draw_text(&draw_text);
+  cig_assign_query_font(&query_font);
+  cig_assign_set_clip(&set_clip);
+  target = NULL;
+}
+
+static void assign_software_backend() {
+  cig_sw_assign_callbacks();
+  cig_sw_framebuffer_init(&framebuffer, pixels, 640, 480);
+  target = &framebuffer;
+}
+
+static void run_scene(const char *name, void (*build)(int), int ticks) {
+  int tick;
+  double t0;
+
+  cig_init_context(&ctx);
+  cig_set_allocator(&ctx, (cig_allocator) {
+    .alloc = bench_alloc,
+    .realloc = bench_realloc,
+    .free = bench_free
+  });
+
+  peak_tracked_bytes = 0;
+
+  /*  First tick allocates all the retained state, it's not timed so the
+      numbers reflect a steady state UI */
+  tick_scene(build, 0);
+
+  alloc_calls = 0;
+  t0 = now_ns();
+
+  for (tick = 1; tick <= ticks; ++tick) {
+    tick_scene(build, tick);
+  }
+
+  const double elapsed = now_ns() - t0;
+
+  /*  Nothing is kept alive on an empty tick, releasing all the state memory */
+  tick_scene(&empty_scene, ticks + 1);
+
+  printf(
+    "{\"scene\":\"%s\",\"backend\":\"%s\",\"ticks\":%d,\"ns_per_tick\":%.0f,\"allocs_per_tick\":%.3f,\"peak_tracked_bytes\":%zu}\n",
+    name,
+    target ? "software" : "stub",
+    ticks,
+    elapsed / ticks,
+    (double)alloc_calls / ticks,
+    peak_tracked_bytes
+  );
+}
+
+int main(int argc, char **argv) {
+  size_t i;
+  const int ticks = argc > 1 ? atoi(argv[1]) : DEFAULT_TICKS;
+  const char *filter = argc > 2 ? argv[2] : NULL;
+
+  if (ticks <= 0) {
+    fprintf(stderr, "Usage: %s [ticks] [scene]\n", argv[0]);
+    return 1;
+  }
+
+  for (i = 0; i < sizeof(scenes) / sizeof(scenes[0]); ++i) {
+    if (!filter || strstr(scenes[i].name, filter)) {
+      assign_stub_backend();
+      run_scene(scenes[i].name, scenes[i].build, ticks);
+      assign_software_backend();
+      run_scene(scenes[i].name, scenes[i].build, ticks);
+    }
+  }
+
+  return 0;
+}
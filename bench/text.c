@@ -0,0 +1,177 @@
+#include "cigcore.h"
+#include "cigtext.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*  Label parsing throughput in MB/s. Each corpus is one long label that is
+    parsed again every tick by bumping its version, wrapped to the screen
+    width and without wrapping, with tags enabled and as plain text. Resize
+    keeps the text and narrows the frame by a pixel every tick instead.
+
+    Usage: bench_text [ticks] */
+
+#define DEFAULT_TICKS 200
+#define CORPUS_BYTES (256 << 10)
+#define SCREEN cig_r_make(0, 0, 640, 480)
+
+static cig_context ctx;
+static volatile size_t sink;
+
+static const char *english =
+  "It was the best of times, it was the worst of times, it was the age of "
+  "wisdom, it was the age of foolishness, it was the epoch of belief, it was "
+  "the epoch of incredulity, it was the season of Light, it was the season of "
+  "Darkness, it was the spring of hope, it was the winter of despair.\n";
+
+static const char *mixed =
+  "Hello world, Tere maailm, Olá mundo. Привет, мир! Γειά σου Κόσμε! "
+  "こんにちは世界。你好，世界。 مرحبا بالعالم. שלום עולם. "
+  "Grüße aus Köln, naïve café, smørrebrød and crème brûlée.\n";
+
+static void* bench_alloc(void *ud, size_t size, size_t align) {
+  return malloc(size);
+}
+
+static void* bench_realloc(void *ud, void *ptr, size_t old_size, size_t new_size) {
+  return realloc(ptr, new_size);
+}
+
+static void bench_free(void *ud, void *ptr) {
+  free(ptr);
+}
+
+/*  Proportional 14px font without kerning. Like a real backend, text is
+    measured by decoding it and adding up the advance of every glyph */
+static cig_v measure_text(const char *str, size_t len, cig_font_ref font, cig_text_style style) {
+  static const unsigned char ascii_advances[128] = {
+    [' '] = 4, ['!'] = 4, [','] = 4, ['.'] = 4, ['\''] = 3,
+    ['a'] = 7, ['b'] = 8, ['c'] = 7, ['d'] = 8, ['e'] = 7, ['f'] = 4, ['g'] = 8,
+    ['h'] = 8, ['i'] = 3, ['j'] = 3, ['k'] = 7, ['l'] = 3, ['m'] = 11, ['n'] = 8,
+    ['o'] = 8, ['p'] = 8, ['q'] = 8, ['r'] = 5, ['s'] = 7, ['t'] = 4, ['u'] = 8,
+    ['v'] = 7, ['w'] = 10, ['x'] = 7, ['y'] = 7, ['z'] = 7
+  };
+  size_t i = 0;
+  int32_t width = 0;
+
+  while (i < len) {
+    const unsigned char c = str[i];
+    uint32_t codepoint;
+
+    if (c < 0x80) {
+      codepoint = c;
+      i += 1;
+    } else if (c < 0xE0) {
+      codepoint = ((c & 0x1F) << 6) | (str[i+1] & 0x3F);
+      i += 2;
+    } else if (c < 0xF0) {
+      codepoint = ((c & 0x0F) << 12) | ((str[i+1] & 0x3F) << 6) | (str[i+2] & 0x3F);
+      i += 3;
+    } else {
+      codepoint = ((c & 0x07) << 18) | ((str[i+1] & 0x3F) << 12) | ((str[i+2] & 0x3F) << 6) | (str[i+3] & 0x3F);
+      i += 4;
+    }
+
+    if (codepoint < 128) {
+      width += ascii_advances[codepoint] ? ascii_advances[codepoint] : 9;
+    } else {
+      width += codepoint >= 0x3000 ? 14 : 8;
+    }
+  }
+
+  return cig_v_make(width, 14);
+}
+
+static void draw_text(const char *str, size_t len, cig_r rect, cig_font_ref font, cig_text_color_ref color, cig_text_style style) {
+  sink += len;
+}
+
+static cig_font_info_st query_font(cig_font_ref font) {
+  return (cig_font_info_st) { .height = 14, .baseline_offset = 0, .cache_advances = true };
+}
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static char* make_corpus(const char *paragraph) {
+  const size_t length = strlen(paragraph);
+  char *text = malloc(CORPUS_BYTES + 1), *p = text;
+
+  while (p + length <= text + CORPUS_BYTES) {
+    memcpy(p, paragraph, length);
+    p += length;
+  }
+  *p = '\0';
+
+  return text;
+}
+
+static void run(const char *name, const char *text, unsigned int flags, bool resize, int ticks) {
+  const size_t length = strlen(text);
+  int tick;
+  double t0 = 0;
+
+  cig_init_context(&ctx);
+  cig_set_allocator(&ctx, (cig_allocator) {
+    .alloc = bench_alloc,
+    .realloc = bench_realloc,
+    .free = bench_free
+  });
+
+  /*  First tick allocates the label and grows its spans, it's not timed */
+  for (tick = 0; tick <= ticks; ++tick) {
+    if (tick == 1) {
+      t0 = now_ns();
+    }
+
+    cig_begin_layout(&ctx, NULL, SCREEN, 1.f / 60.f);
+    if (cig_push_frame(resize ? cig_r_make(0, 0, 640 - tick % 64, 480) : SCREEN)) {
+      cig_draw_label_versioned((cig_text_properties) {
+        .alignment = { CIG_TEXT_ALIGN_LEFT, CIG_TEXT_ALIGN_TOP },
+        .flags = flags
+      }, resize ? 0 : tick, text);
+      cig_pop_frame();
+    }
+    cig_end_layout();
+  }
+
+  const double seconds = (now_ns() - t0) / 1e9;
+
+  printf("%-24s %8.1f MB/s\n", name, (double)length * ticks / seconds / (1 << 20));
+}
+
+int main(int argc, char **argv) {
+  const int ticks = argc > 1 ? atoi(argv[1]) : DEFAULT_TICKS;
+  char *english_corpus = make_corpus(english);
+  char *mixed_corpus = make_corpus(mixed);
+
+  if (ticks <= 0) {
+    fprintf(stderr, "Usage: %s [ticks]\n", argv[0]);
+    return 1;
+  }
+
+  cig_assign_measure_text(&measure_text);
+  cig_assign_draw_text(&draw_text);
+  cig_assign_query_font(&query_font);
+
+  printf("label parsing, %d KB corpora, %d ticks\n", CORPUS_BYTES >> 10, ticks);
+
+  run("english", english_corpus, 0, false, ticks);
+  run("english (no wrap)", english_corpus, CIG_TEXT_HORIZONTAL_WRAP_DISABLED, false, ticks);
+  run("english (plain)", english_corpus, CIG_TEXT_PLAIN, false, ticks);
+  run("english (resize)", english_corpus, 0, true, ticks);
+  run("mixed", mixed_corpus, 0, false, ticks);
+  run("mixed (no wrap)", mixed_corpus, CIG_TEXT_HORIZONTAL_WRAP_DISABLED, false, ticks);
+  run("mixed (resize)", mixed_corpus, 0, true, ticks);
+
+  free(english_corpus);
+  free(mixed_corpus);
+
+  return 0;
+}
@@ -7,6 +7,9 @@
 #define DEPS_FOLDER  "deps/"
 #define TESTS_FOLDER "tests/"
 #define DEMO_FOLDER  "demo/"
+#define BENCH_FOLDER "bench/"
+#define BACKENDS_FOLDER "backends/"
+#define TOOLS_FOLDER "tools/"
 
 int main(int argc, char **argv)
 {
@@ -14,7 +17,9 @@ int main(int argc, char **argv)
   
   enum targets {
     TARGET_TEST = 1,
-    TARGET_RAYLIB_DEMO = 2
+    TARGET_RAYLIB_DEMO = 2,
+    TARGET_BENCH = 4,
+    TARGET_HEADLESS_DEMO = 8
   };
   
   int targets_included = 0;
@@ -25,6 +30,8 @@ int main(int argc, char **argv)
     printf("Arguments:\n");
     printf("\ttest\tBuilds the test target\n");
     printf("\tdemo\tBuilds the demo target\n");
+    printf("\tbench\tBuilds the benchmarks and the layout snapshot diff tool\n");
+    printf("\theadless\tBuilds the demo with the software backend and scripted input\n");
     printf("\tall\tBuilds both test and demo targets\n");
     return 0;
   } else {
@@ -36,6 +43,10 @@ int main(int argc, char **argv)
         targets_included |= TARGET_TEST;
       } else if (!strcmp(argv[i], "demo")) {
         targets_included |= TARGET_RAYLIB_DEMO;
+      } else if (!strcmp(argv[i], "bench")) {
+        targets_included |= TARGET_BENCH;
+      } else if (!strcmp(argv[i], "headless")) {
+        targets_included |= TARGET_HEADLESS_DEMO;
       } else {
         printf("Unknown target '%s'!\n", argv[i]);
         return 1;
@@ -66,8 +77,10 @@ int main(int argc, char **argv)
       "-I"DEPS_FOLDER"utf8/",
       "-I"DEPS_FOLDER"unity/src/",
       "-I"DEPS_FOLDER"unity/extras/fixture/src/",
+      "-I"BACKENDS_FOLDER"software/",
 
       "-DDEBUG",
+      "-DCIG_PROFILE",
       "-DUNITY_INCLUDE_PRINT_FORMATTED",
       "-DUNITY_INCLUDE_DOUBLE",
 
@@ -80,22 +93,177 @@ int main(int argc, char **argv)
       DEPS_FOLDER"utf8/utf8.c",
       SRC_FOLDER"cigcore.c",
       SRC_FOLDER"cigtext.c",
+      SRC_FOLDER"cigtextview.c",
       SRC_FOLDER"cigimage.c",
+      SRC_FOLDER"cigrecord.c",
+      SRC_FOLDER"cigsnapshot.c",
+      BACKENDS_FOLDER"software/cigsoftware.c",
       TESTS_FOLDER"main.c",
       TESTS_FOLDER"core/layout.c",
       TESTS_FOLDER"core/state.c",
       TESTS_FOLDER"core/input.c",
       TESTS_FOLDER"core/macros.c",
+      TESTS_FOLDER"core/record.c",
+      TESTS_FOLDER"core/snapshot.c",
+      TESTS_FOLDER"core/profile.c",
       TESTS_FOLDER"text/label.c",
       TESTS_FOLDER"text/style.c",
+      TESTS_FOLDER"text/view.c",
       TESTS_FOLDER"image/image.c",
+      TESTS_FOLDER"backends/software.c",
       TESTS_FOLDER"allocator.c",
-      TESTS_FOLDER"types.c"
+      TESTS_FOLDER"types.c",
+
+      "-lm"
     );
 
     if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
   }
   
+  if (targets_included & TARGET_BENCH) {
+    nob_cmd_append(
+      &cmd,
+      "gcc",
+      "-std=gnu99",
+      "-Wall",
+      "-Wno-missing-field-initializers",
+      "-Wno-unused-parameter",
+      "-Wfatal-errors",
+      "-O2",
+
+      "-I"SRC_FOLDER,
+      "-I"DEPS_FOLDER,
+
+      "-o", BIN_FOLDER"bench_rect",
+
+      BENCH_FOLDER"rect.c"
+    );
+
+    if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
+
+    nob_cmd_append(
+      &cmd,
+      "gcc",
+      "-std=gnu99",
+      "-Wall",
+      "-Wno-missing-field-initializers",
+      "-Wno-unused-parameter",
+      "-Wfatal-errors",
+      "-O2",
+
+      "-I"SRC_FOLDER,
+      "-I"DEPS_FOLDER,
+
+      "-o", BIN_FOLDER"bench_gap_buffer",
+
+      BENCH_FOLDER"gap_buffer.c"
+    );
+
+    if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
+
+    nob_cmd_append(
+      &cmd,
+      "gcc",
+      "-std=gnu99",
+      "-Wall",
+      "-Wno-missing-field-initializers",
+      "-Wno-unused-parameter",
+      "-Wfatal-errors",
+      "-O2",
+
+      "-I"SRC_FOLDER,
+      "-I"DEPS_FOLDER,
+
+      "-o", BIN_FOLDER"bench_piece_table",
+
+      BENCH_FOLDER"piece_table.c"
+    );
+
+    if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
+
+    nob_cmd_append(
+      &cmd,
+      "gcc",
+      "-std=gnu99",
+      "-Wall",
+      "-Wno-missing-field-initializers",
+      "-Wno-unused-parameter",
+      "-Wfatal-errors",
+      "-O2",
+      "-DNDEBUG",
+
+      "-I"SRC_FOLDER,
+      "-I"DEPS_FOLDER,
+      "-I"DEPS_FOLDER"utf8/",
+
+      "-o", BIN_FOLDER"bench_text",
+
+      DEPS_FOLDER"utf8/utf8.c",
+      SRC_FOLDER"cigcore.c",
+      SRC_FOLDER"cigtext.c",
+      BENCH_FOLDER"text.c",
+
+      "-lm"
+    );
+
+    if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
+
+    nob_cmd_append(
+      &cmd,
+      "gcc",
+      "-std=gnu99",
+      "-Wall",
+      "-Wno-missing-field-initializers",
+      "-Wno-unused-parameter",
+      "-Wfatal-errors",
+      "-O2",
+      "-DNDEBUG",
+
+      "-I"SRC_FOLDER,
+      "-I"DEPS_FOLDER,
+      "-I"DEPS_FOLDER"utf8/",
+      "-I"BACKENDS_FOLDER"software/",
+
+      "-o", BIN_FOLDER"bench_scenes",
+
+      DEPS_FOLDER"utf8/utf8.c",
+      SRC_FOLDER"cigcore.c",
+      SRC_FOLDER"cigtext.c",
+      SRC_FOLDER"cigtextview.c",
+      SRC_FOLDER"cigimage.c",
+      BACKENDS_FOLDER"software/cigsoftware.c",
+      BENCH_FOLDER"scenes.c",
+
+      "-lm"
+    );
+
+    if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
+
+    nob_cmd_append(
+      &cmd,
+      "gcc",
+      "-std=gnu99",
+      "-Wall",
+      "-Wno-missing-field-initializers",
+      "-Wno-unused-parameter",
+      "-Wfatal-errors",
+      "-O2",
+
+      "-I"SRC_FOLDER,
+      "-I"DEPS_FOLDER,
+
+      "-o", BIN_FOLDER"snapshot_diff",
+
+      SRC_FOLDER"cigcore.c",
+      SRC_FOLDER"cigsnapshot.c",
+      TOOLS_FOLDER"snapshot_diff.c",
+
+      "-lm"
+    );
+
+    if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
+  }
+
   if (targets_included & TARGET_RAYLIB_DEMO) {
     nob_cmd_append(
       &cmd,
@@ -147,5 +315,54 @@ int main(int argc, char **argv)
     nob_copy_directory_recursively(DEMO_FOLDER"win95/res", BIN_FOLDER"res");
   }
 
+  if (targets_included & TARGET_HEADLESS_DEMO) {
+    nob_cmd_append(
+      &cmd,
+      "gcc",
+      "-std=gnu99",
+      "-Wall",
+      "-Wno-missing-field-initializers",
+      "-Wno-unused-parameter",
+      "-Wfatal-errors",
+      "-O2",
+
+      "-I"SRC_FOLDER,
+      "-I"DEPS_FOLDER,
+      "-I"DEMO_FOLDER"win95/",
+      "-I"DEPS_FOLDER"utf8/",
+      "-I"BACKENDS_FOLDER"software/",
+
+      "-o", BIN_FOLDER"win95_headless",
+
+      DEPS_FOLDER"utf8/utf8.c",
+      SRC_FOLDER"cigcore.c",
+      SRC_FOLDER"cigtext.c",
+      SRC_FOLDER"cigimage.c",
+      SRC_FOLDER"cigrecord.c",
+      SRC_FOLDER"cigsnapshot.c",
+      BACKENDS_FOLDER"software/cigsoftware.c",
+      DEMO_FOLDER"win95/headless.c",
+      DEMO_FOLDER"win95/win95.c",
+      DEMO_FOLDER"win95/cigext.c",
+      DEMO_FOLDER"win95/system/window_manager.c",
+      DEMO_FOLDER"win95/components/window.c",
+      DEMO_FOLDER"win95/components/button.c",
+      DEMO_FOLDER"win95/components/menu.c",
+      DEMO_FOLDER"win95/components/file_browser.c",
+      DEMO_FOLDER"win95/components/scroller.c",
+      DEMO_FOLDER"win95/apps/explorer/explorer.c",
+      DEMO_FOLDER"win95/apps/welcome/welcome.c",
+      DEMO_FOLDER"win95/apps/games/wordwiz/wordwiz.c",
+      DEMO_FOLDER"win95/apps/accessories/calculator/calculator.c",
+
+      "-lm"
+    );
+
+    if (!nob_cmd_run_sync_and_reset(&cmd)) return 1;
+
+    /*  WordWiz loads its dictionaries relative to the working directory */
+    nob_copy_directory_recursively(DEMO_FOLDER"win95/res", BIN_FOLDER"res");
+  }
+
   return 0;
 }
@@ -135,7 +135,7 @@ void menu_draw(win95_menu *this, menu_presentation presentation, bool *prevent_c
             icon_width,
             icon_title_spacing,
             after_title_spacing;
-  } size_info;
+  } size_info = { 0 };
 
   const cig_i panel_insets = cig_i_uniform(3);
 
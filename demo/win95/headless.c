@@ -0,0 +1,608 @@
+#include "cig.h"
+#include "win95.h"
+#include "cigext.h"
+#include "cigsoftware.h"
+#include "cigrecord.h"
+#include "cigsnapshot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+
+/*  Headless runner for the demo. Runs the same desktop and apps as `main.c`
+    but renders with the software backend (or not at all with --stub) and
+    feeds scripted input instead of reading a real mouse and keyboard.
+    Prints a JSON line per tick and a summary at the end.
+
+    Input can be recorded to a file with --record, and a recorded session
+    (from here or any other runner using `cig_record_start`) replayed with
+    --replay in place of the script, until the log ends or for -n ticks.
+    --snapshot writes the layout of every tick for `snapshot_diff`.
+
+    Usage: win95_headless [-n ticks] [--stub] [-q] [-o frame.ppm]
+                          [--record input.cigr | --replay input.cigr]
+                          [--snapshot layout.cigs] */
+
+#define SCREEN_W 640
+#define SCREEN_H 480
+#define DELTA_TIME (1.f / 60.f)
+
+static cig_context ctx = { 0 };
+static uint32_t pixels[SCREEN_W * SCREEN_H];
+static cig_sw_framebuffer framebuffer;
+static win95_t win_instance = { 0 };
+
+static cig_sw_font fonts[__FONT_COUNT];
+static uint32_t colors[__COLOR_COUNT];
+static int panel_styles[__STYLE_COUNT];
+static cig_sw_image images[__IMAGE_COUNT];
+
+void* get_font(font_id_t id) {
+  return &fonts[id];
+}
+
+void* get_color(color_id_t id) {
+  return &colors[id];
+}
+
+void* get_image(image_id_t id) {
+  return &images[id];
+}
+
+void* get_style(style_id_t id) {
+  return &panel_styles[id];
+}
+
+void enable_blue_selection_dithering(bool enabled) {}
+
+/*  ┌───────────┐
+    │ RESOURCES │
+    └───────────┘ */
+
+/*  Images aren't decoded here, each one is a flat placeholder of roughly the
+    right size so layout and blitting costs are in the same ballpark */
+static void set_up_resources() {
+  int i, p;
+
+  for (i = 0; i < __FONT_COUNT; ++i) {
+    fonts[i] = cig_sw_default_font(i <= FONT_BOLD ? 1 : 4);
+  }
+
+  colors[COLOR_DEBUG] = CIG_SW_RGBA(255, 0, 255, 255);
+  colors[COLOR_BLACK] = CIG_SW_RGBA(0, 0, 0, 255);
+  colors[COLOR_WHITE] = CIG_SW_RGBA(255, 255, 255, 255);
+  colors[COLOR_YELLOW] = CIG_SW_RGBA(255, 255, 0, 255);
+  colors[COLOR_GREEN] = CIG_SW_RGBA(0, 128, 0, 255);
+  colors[COLOR_RED] = CIG_SW_RGBA(255, 0, 0, 255);
+  colors[COLOR_MAROON] = CIG_SW_RGBA(128, 0, 0, 255);
+  colors[COLOR_BLUE] = CIG_SW_RGBA(0, 0, 255, 255);
+  colors[COLOR_NAVY] = CIG_SW_RGBA(0, 0, 128, 255);
+  colors[COLOR_DESKTOP_BG] = CIG_SW_RGBA(0, 127, 127, 255);
+  colors[COLOR_DIALOG_BACKGROUND] = CIG_SW_RGBA(195, 195, 195, 255);
+  colors[COLOR_WINDOW_ACTIVE_TITLEBAR] = CIG_SW_RGBA(0, 0, 127, 255);
+  colors[COLOR_WINDOW_INACTIVE_TITLEBAR] = CIG_SW_RGBA(127, 127, 127, 255);
+
+  for (i = 0; i < __STYLE_COUNT; ++i) { panel_styles[i] = i; }
+
+  for (i = 0; i < __IMAGE_COUNT; ++i) {
+    int size = 16;
+
+    switch (i) {
+    case IMAGE_CHECKMARK: case IMAGE_CROSS: case IMAGE_MAXIMIZE: case IMAGE_MINIMIZE:
+    case IMAGE_RESTORE: case IMAGE_SCROLL_UP: case IMAGE_SCROLL_DOWN: case IMAGE_SCROLL_LEFT:
+    case IMAGE_SCROLL_RIGHT: case IMAGE_RESIZE_HANDLE: case IMAGE_MENU_CHECK:
+    case IMAGE_MENU_CHECK_INVERTED: case IMAGE_MENU_RADIO: case IMAGE_MENU_RADIO_INVERTED:
+    case IMAGE_MENU_ARROW: case IMAGE_MENU_ARROW_INVERTED:
+      size = 8; break;
+    case IMAGE_PROGRAM_FOLDER_24: case IMAGE_DOCUMENTS_24: case IMAGE_SETTINGS_24:
+    case IMAGE_FIND_24: case IMAGE_HELP_24: case IMAGE_RUN_24: case IMAGE_SHUT_DOWN_24:
+      size = 24; break;
+    case IMAGE_MY_COMPUTER_32: case IMAGE_TIP_OF_THE_DAY: case IMAGE_WELCOME_APP_ICON:
+    case IMAGE_BIN_EMPTY: case IMAGE_DRIVE_A_32: case IMAGE_DRIVE_C_32: case IMAGE_DRIVE_D_32:
+    case IMAGE_CONTROLS_FOLDER_32: case IMAGE_PRINTERS_FOLDER_32: case IMAGE_DIAL_UP_FOLDER_32:
+      size = 32; break;
+    case IMAGE_LOGO_TEXT: case IMAGE_BRIGHT_YELLOW_PATTERN: case IMAGE_GRAY_DITHER:
+      size = 64; break;
+    default: break;
+    }
+
+    uint32_t *image_pixels = malloc(sizeof(uint32_t) * size * size);
+    for (p = 0; p < size * size; ++p) {
+      image_pixels[p] = CIG_SW_RGBA(i * 37, i * 91, i * 53, 255);
+    }
+
+    images[i] = (cig_sw_image) { image_pixels, size, size };
+  }
+}
+
+/*  ┌──────────────────────┐
+    │ EXTENSION CALLBACKS  │
+    └──────────────────────┘ */
+
+M_INLINED void fill(cig_r rect, uint32_t color) {
+  cig_sw_fill_rect((cig_sw_framebuffer*)cig_buffer(), rect, color);
+}
+
+/*  Single pixel bevel: light top-left and dark bottom-right edges */
+static void bevel(cig_r r, uint32_t light, uint32_t dark) {
+  fill(cig_r_make(r.x, r.y, r.w, 1), light);
+  fill(cig_r_make(r.x, r.y, 1, r.h), light);
+  fill(cig_r_make(r.x, r.y + r.h - 1, r.w, 1), dark);
+  fill(cig_r_make(r.x + r.w - 1, r.y, 1, r.h), dark);
+}
+
+static void draw_style(cig_style_ref style_ref, cig_r rect, cig_style_modifiers modifiers) {
+  const uint32_t white = colors[COLOR_WHITE],
+                 black = colors[COLOR_BLACK],
+                 gray = CIG_SW_RGBA(130, 130, 130, 255),
+                 background = colors[COLOR_DIALOG_BACKGROUND];
+
+  switch (*(int*)style_ref) {
+  case STYLE_STANDARD_DIALOG:
+    fill(rect, background);
+    bevel(rect, background, black);
+    bevel(cig_r_inset(rect, cig_i_uniform(1)), white, gray);
+    break;
+
+  case STYLE_BUTTON:
+  case STYLE_SCROLL_BUTTON:
+    fill(rect, background);
+    if (modifiers & (CIG_STYLE_APPLY_PRESS | CIG_STYLE_APPLY_SELECTION)) {
+      bevel(rect, black, white);
+      bevel(cig_r_inset(rect, cig_i_uniform(1)), gray, background);
+    } else {
+      bevel(rect, white, black);
+      bevel(cig_r_inset(rect, cig_i_uniform(1)), background, gray);
+    }
+    break;
+
+  case STYLE_LIGHT_YELLOW:
+    fill(rect, CIG_SW_RGBA(255, 255, 225, 255));
+    break;
+
+  case STYLE_GRAY_DITHER:
+    fill(rect, CIG_SW_RGBA(225, 225, 225, 255));
+    break;
+
+  case STYLE_INNER_BEVEL_NO_FILL:
+    bevel(rect, gray, white);
+    break;
+
+  case STYLE_FILES_CONTENT_BEVEL:
+    bevel(rect, gray, white);
+    bevel(cig_r_inset(rect, cig_i_uniform(1)), black, background);
+    break;
+  }
+}
+
+static void draw_rectangle(cig_color_ref fill_color, cig_color_ref border_color, cig_r rect, unsigned int border_width) {
+  const int w = border_width;
+
+  if (fill_color) {
+    fill(rect, *(uint32_t*)fill_color);
+  }
+  if (border_color && w > 0) {
+    const uint32_t color = *(uint32_t*)border_color;
+    fill(cig_r_make(rect.x, rect.y, rect.w, w), color);
+    fill(cig_r_make(rect.x, rect.y + rect.h - w, rect.w, w), color);
+    fill(cig_r_make(rect.x, rect.y + w, w, rect.h - w * 2), color);
+    fill(cig_r_make(rect.x + rect.w - w, rect.y + w, w, rect.h - w * 2), color);
+  }
+}
+
+static void draw_line(cig_color_ref color_ref, cig_v p0, cig_v p1, float thickness) {
+  const uint32_t color = *(uint32_t*)color_ref;
+  const int t = thickness < 1 ? 1 : (int)thickness;
+
+  if (p0.y == p1.y) {
+    fill(cig_r_make(M_MIN(p0.x, p1.x), p0.y, abs(p1.x - p0.x) + 1, t), color);
+  } else if (p0.x == p1.x) {
+    fill(cig_r_make(p0.x, M_MIN(p0.y, p1.y), t, abs(p1.y - p0.y) + 1), color);
+  } else {
+    /*  Bresenham for the rare diagonal line */
+    const int dx = abs(p1.x - p0.x), sx = p0.x < p1.x ? 1 : -1;
+    const int dy = -abs(p1.y - p0.y), sy = p0.y < p1.y ? 1 : -1;
+    int err = dx + dy, x = p0.x, y = p0.y;
+
+    for (;;) {
+      fill(cig_r_make(x, y, t, t), color);
+      if (x == p1.x && y == p1.y) { break; }
+      const int e2 = 2 * err;
+      if (e2 >= dy) { err += dy; x += sx; }
+      if (e2 <= dx) { err += dx; y += sy; }
+    }
+  }
+}
+
+/*  Layout only: text and images are still measured, nothing is drawn */
+static void stub_draw_text(const char *str, size_t len, cig_r rect, cig_font_ref font, cig_text_color_ref color, cig_text_style style) {}
+static void stub_draw_image(cig_buffer_ref buffer, cig_r container, cig_r rect, cig_image_ref image, cig_image_mode mode) {}
+static void stub_set_clip(cig_buffer_ref buffer, cig_r rect, bool reset) {}
+static void stub_draw_style(cig_style_ref style, cig_r rect, cig_style_modifiers modifiers) {}
+static void stub_draw_rectangle(cig_color_ref fill_color, cig_color_ref border_color, cig_r rect, unsigned int border_width) {}
+static void stub_draw_line(cig_color_ref color, cig_v p0, cig_v p1, float thickness) {}
+
+/*  ┌────────┐
+    │ SCRIPT │
+    └────────┘ */
+
+typedef enum {
+  STEP_IDLE,          /* Nothing happens for `ticks` */
+  STEP_CLICK,         /* Primary button click at `v` */
+  STEP_DOUBLE_CLICK,  /* Two quick clicks at `v` */
+  STEP_DRAG_WINDOW,   /* Drags the topmost window by its titlebar by `v` over `ticks` */
+  STEP_TYPE,          /* Taps a key for every character in `text`: A-Z, \b and \n */
+  STEP_MOVE,          /* Moves the pointer to `v` and waits for `ticks` */
+  STEP_LOOP           /* Continues from step `v.x` */
+} step_kind;
+
+typedef struct {
+  step_kind kind;
+  int ticks;
+  cig_v v;
+  const char *text;
+} step_t;
+
+static const step_t script[] = {
+  { STEP_IDLE, 10 },
+  { STEP_DOUBLE_CLICK, .v = { 37, 25 } },   /* "My Computer" desktop icon opens Explorer */
+  { STEP_IDLE, 10 },
+  { STEP_CLICK, .v = { 25, 467 } },         /* Start -> Programs -> Accessories -> Games -> WordWiz */
+  { STEP_MOVE, 40, .v = { 90, 237 } },
+  { STEP_MOVE, 40, .v = { 230, 231 } },
+  { STEP_MOVE, 40, .v = { 400, 231 } },    /* Child menus open after a short hover */
+  { STEP_CLICK, .v = { 515, 231 } },
+  { STEP_IDLE, 5 },
+  { STEP_TYPE, .text = "CRANE" },           /* Loop starts here */
+  { STEP_TYPE, .text = "\b\b\b\b\b" },
+  { STEP_DRAG_WINDOW, 30, .v = { 120, 40 } },
+  { STEP_DRAG_WINDOW, 30, .v = { -120, -40 } },
+  { STEP_IDLE, 10 },
+  { STEP_LOOP, .v = { 9 } }
+};
+
+static struct {
+  size_t step;
+  int tick;                     /* Tick within the current step */
+  cig_v pointer, drag_origin;
+  bool pointer_down;
+  bool keys[CIG__KEY_COUNT];
+} player;
+
+static cig_key_code key_for(char c) {
+  if (c >= 'A' && c <= 'Z') { return CIG_KEY_A + (c - 'A'); }
+  if (c == '\b') { return CIG_KEY_BACKSPACE; }
+  if (c == '\n') { return CIG_KEY_ENTER; }
+  return CIG_KEY_NONE;
+}
+
+static cig_v topmost_titlebar() {
+  window_manager_t *wm = &win_instance.window_manager;
+  if (!wm->count) {
+    return cig_v_make(SCREEN_W / 2, SCREEN_H / 2);
+  }
+  const cig_r rect = wm->order[wm->count - 1]->rect;
+  return cig_v_make(rect.x + 40, rect.y + 10);
+}
+
+/*  Advances the script by one tick and returns whether the step finished */
+static bool play_step(const step_t *step, int t) {
+  memset(player.keys, 0, sizeof(player.keys));
+
+  switch (step->kind) {
+  case STEP_IDLE:
+    player.pointer_down = false;
+    return t + 1 >= step->ticks;
+
+  case STEP_CLICK:
+  case STEP_DOUBLE_CLICK:
+    /*  Move, press, release (press, release) */
+    player.pointer = step->v;
+    player.pointer_down = t % 2 == 1;
+    return t >= (step->kind == STEP_CLICK ? 2 : 4);
+
+  case STEP_DRAG_WINDOW:
+    if (t == 0) {
+      player.drag_origin = player.pointer = topmost_titlebar();
+      player.pointer_down = false;
+    } else if (t <= step->ticks + 1) {
+      const float f = (float)(t - 1) / step->ticks;
+      player.pointer = cig_v_make(player.drag_origin.x + step->v.x * f, player.drag_origin.y + step->v.y * f);
+      player.pointer_down = true;
+    } else {
+      player.pointer_down = false;
+      return true;
+    }
+    return false;
+
+  case STEP_TYPE:
+    player.keys[key_for(step->text[t / 2])] = t % 2 == 0;
+    return t + 1 >= (int)strlen(step->text) * 2;
+
+  case STEP_MOVE:
+    player.pointer = step->v;
+    player.pointer_down = false;
+    return t + 1 >= step->ticks;
+
+  case STEP_LOOP:
+    return true;
+  }
+
+  return true;
+}
+
+static void play_script() {
+  const step_t *step = &script[player.step];
+
+  if (step->kind == STEP_LOOP) {
+    player.step = step->v.x;
+    player.tick = 0;
+    step = &script[player.step];
+  }
+
+  if (play_step(step, player.tick++)) {
+    player.step = (player.step + 1) % (sizeof(script) / sizeof(script[0]));
+    player.tick = 0;
+  }
+
+  int i;
+
+  cig_set_pointer_position(player.pointer);
+  cig_set_pointer_state(player.pointer_down ? CIG_INPUT_PRIMARY_ACTION : 0);
+  for (i = 0; i < CIG__KEY_COUNT; ++i) {
+    cig_set_key_state((cig_key_code)i, player.keys[i]);
+  }
+}
+
+/*  ┌────────┐
+    │ RUNNER │
+    └────────┘ */
+
+static size_t alloc_count;
+
+static void* headless_alloc(void *ud, size_t size, size_t align) {
+  alloc_count++;
+  return calloc(1, size);
+}
+
+static void* headless_realloc(void *ud, void *ptr, size_t old_size, size_t new_size) {
+  alloc_count++;
+  void *new_bytes = realloc(ptr, new_size);
+  if (new_size > old_size) {
+    memset((char*)new_bytes + old_size, 0, new_size - old_size);
+  }
+  return new_bytes;
+}
+
+static void headless_free(void *ud, void *ptr) {
+  free(ptr);
+}
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void write_to_file(const void *bytes, size_t size, void *file) {
+  fwrite(bytes, 1, size, file);
+}
+
+static void* read_file(const char *path, size_t *size) {
+  FILE *file = fopen(path, "rb");
+  void *bytes;
+
+  if (!file) {
+    return NULL;
+  }
+
+  fseek(file, 0, SEEK_END);
+  *size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  bytes = malloc(*size);
+  if (fread(bytes, 1, *size, file) != *size) {
+    free(bytes);
+    bytes = NULL;
+  }
+  fclose(file);
+
+  return bytes;
+}
+
+static bool write_ppm(const char *path) {
+  int i;
+  FILE *file = fopen(path, "wb");
+
+  if (!file) {
+    return false;
+  }
+
+  fprintf(file, "P6\n%d %d\n255\n", SCREEN_W, SCREEN_H);
+  for (i = 0; i < SCREEN_W * SCREEN_H; ++i) {
+    fwrite(&pixels[i], 1, 3, file);
+  }
+  fclose(file);
+
+  return true;
+}
+
+int main(int argc, const char *argv[]) {
+  int i, ticks = -1;
+  bool stub = false, quiet = false;
+  const char *output = NULL, *record_path = NULL, *replay_path = NULL, *snapshot_path = NULL;
+  double total = 0, slowest = 0;
+  FILE *record_file = NULL, *snapshot_file = NULL;
+  cig_recorder recorder;
+  cig_snapshot snapshot;
+  cig_replay replay;
+  void *replay_bytes = NULL;
+
+  for (i = 1; i < argc; ++i) {
+    if (!strcmp("-n", argv[i]) && i + 1 < argc) {
+      ticks = atoi(argv[++i]);
+    } else if (!strcmp("--stub", argv[i])) {
+      stub = true;
+    } else if (!strcmp("-q", argv[i])) {
+      quiet = true;
+    } else if (!strcmp("-o", argv[i]) && i + 1 < argc) {
+      output = argv[++i];
+    } else if (!strcmp("--record", argv[i]) && i + 1 < argc) {
+      record_path = argv[++i];
+    } else if (!strcmp("--replay", argv[i]) && i + 1 < argc) {
+      replay_path = argv[++i];
+    } else if (!strcmp("--snapshot", argv[i]) && i + 1 < argc) {
+      snapshot_path = argv[++i];
+    } else {
+      fprintf(stderr, "Usage: %s [-n ticks] [--stub] [-q] [-o frame.ppm] [--record file | --replay file] [--snapshot file]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  /*  Replays run until the recording ends unless limited */
+  if (ticks < 0) {
+    ticks = replay_path ? INT_MAX : 600;
+  }
+
+  if (record_path && !(record_file = fopen(record_path, "wb"))) {
+    fprintf(stderr, "Unable to write %s\n", record_path);
+    return 1;
+  }
+
+  if (snapshot_path && !(snapshot_file = fopen(snapshot_path, "wb"))) {
+    fprintf(stderr, "Unable to write %s\n", snapshot_path);
+    return 1;
+  }
+
+  if (replay_path) {
+    size_t size;
+    if (!(replay_bytes = read_file(replay_path, &size)) || !cig_replay_init(&replay, replay_bytes, size)) {
+      fprintf(stderr, "Unable to read a recording from %s\n", replay_path);
+      return 1;
+    }
+  }
+
+  /*  Window IDs are random, keep runs comparable */
+  srand(1);
+
+  set_up_resources();
+  cig_sw_framebuffer_init(&framebuffer, pixels, SCREEN_W, SCREEN_H);
+
+  cig_init_context(&ctx);
+
+  cig_set_allocator(&ctx, (cig_allocator) {
+    .alloc = headless_alloc,
+    .realloc = headless_realloc,
+    .free = headless_free
+  });
+
+  cig_sw_assign_callbacks();
+  cig_assign_draw_style(&draw_style);
+  cig_assign_draw_rectangle(&draw_rectangle);
+  cig_assign_draw_line(&draw_line);
+
+  if (stub) {
+    cig_assign_draw_text(&stub_draw_text);
+    cig_assign_draw_image(&stub_draw_image);
+    cig_assign_set_clip(&stub_set_clip);
+    cig_assign_draw_style(&stub_draw_style);
+    cig_assign_draw_rectangle(&stub_draw_rectangle);
+    cig_assign_draw_line(&stub_draw_line);
+  }
+
+  cig_set_default_font(&fonts[FONT_REGULAR]);
+  cig_set_default_text_color(&colors[COLOR_BLACK]);
+
+  if (record_file) {
+    cig_record_start(&recorder, &write_to_file, record_file);
+  }
+
+  /*  Same as the raylib runner, gives the first windows a size reference */
+  if (replay_bytes) {
+    if (!cig_replay_tick(&replay, &ctx, &framebuffer)) {
+      fprintf(stderr, "Recording is empty\n");
+      return 1;
+    }
+  } else {
+    cig_begin_layout(&ctx, &framebuffer, cig_r_make(0, 0, SCREEN_W, SCREEN_H), 0.f);
+  }
+  win95_initialize(&win_instance);
+
+  /*  Initialization tick is never ended, layouts are captured from the first full tick */
+  if (snapshot_file) {
+    cig_snapshot_start(&snapshot, &write_to_file, snapshot_file);
+  }
+
+  for (i = 0; i < ticks && win_instance.running; ++i) {
+    alloc_count = 0;
+
+    const double t0 = now_ns();
+
+    if (replay_bytes) {
+      if (!cig_replay_tick(&replay, &ctx, &framebuffer)) {
+        break;
+      }
+    } else {
+      cig_begin_layout(&ctx, &framebuffer, cig_r_make(0, 0, SCREEN_W, SCREEN_H), DELTA_TIME);
+      play_script();
+    }
+    win95_run();
+    cig_end_layout();
+
+    if (snapshot_file) {
+      cig_snapshot_end_tick();
+    }
+
+    const double elapsed = now_ns() - t0;
+    const cig_stats_t *stats = cig_stats();
+
+    total += elapsed;
+    slowest = M_MAX(slowest, elapsed);
+
+    if (!quiet) {
+      printf(
+        "{\"tick\":%d,\"ns\":%.0f,\"frames\":%zu,\"culled\":%zu,\"state_lookups\":%zu,"
+        "\"text_measures\":%zu,\"label_cache_misses\":%zu,\"allocs\":%zu,\"tracked_bytes\":%zu}\n",
+        i,
+        elapsed,
+        (size_t)stats->frames.pushed,
+        (size_t)stats->frames.culled,
+        (size_t)stats->state.lookups,
+        (size_t)stats->text.measure_calls,
+        (size_t)stats->text.label_cache_misses,
+        alloc_count,
+        cig_tracked_bytes()
+      );
+    }
+  }
+
+  if (record_file) {
+    cig_record_stop();
+    fclose(record_file);
+  }
+
+  if (snapshot_file) {
+    cig_snapshot_stop();
+    fclose(snapshot_file);
+  }
+
+  free(replay_bytes);
+
+  /*  Same input gives the same last frame, apart from the taskbar clock */
+  printf(
+    "{\"summary\":true,\"backend\":\"%s\",\"ticks\":%d,\"ns_per_tick\":%.0f,\"slowest_tick_ns\":%.0f,\"frame_hash\":\"%08x\"}\n",
+    stub ? "stub" : "software",
+    i,
+    i ? total / i : 0,
+    slowest,
+    cig_sw_hash(&framebuffer)
+  );
+
+  if (output && !write_ppm(output)) {
+    fprintf(stderr, "Unable to write %s\n", output);
+    return 1;
+  }
+
+  return 0;
+}
@@ -554,7 +554,9 @@ M_INLINED cig_font_info_st font_query(cig_font_ref font_ref) {
   
   return (cig_font_info_st) {
     .height = fs->font.baseSize,
-    .baseline_offset = fs->baseline_offset
+    .baseline_offset = fs->baseline_offset,
+    .cache_advances = true, /* MeasureTextEx with no spacing only adds up glyph advances */
+    .letter_spacing = 0
   };
 }
 
@@ -2,8 +2,6 @@
 #include "system/window_manager.h"
 #include "system/application.h"
 
-#include <time.h>
-
 static void
 window_manager_close(window_manager_t*, window_t*);
 
@@ -39,7 +37,8 @@ window_t* window_manager_create(window_manager_t *manager, struct application_t
       return existing_wnd;
     }
   } else {
-    wnd.id = CIG_TINYHASH(wnd.id, time(NULL));
+    /*  Not time based, so a replayed session gets the same IDs */
+    wnd.id = CIG_TINYHASH(wnd.id, ++manager->created);
   }
 
   for (i = 0; i < WIN95_OPEN_WINDOWS_MAX; ++i) {
@@ -11,6 +11,7 @@ typedef struct {
   window_t windows[WIN95_OPEN_WINDOWS_MAX];
   window_t *order[WIN95_OPEN_WINDOWS_MAX];
   size_t count;
+  unsigned int created;   /* Windows created so far, keeps repeated window IDs unique */
 } window_manager_t;
 
 window_t*
@@ -127,8 +127,10 @@ static void do_taskbar() {
     cig_r_make(0, CIG_H - TASKBAR_H, CIG_W, TASKBAR_H),
     CIG_INSETS(cig_i_make(2, 4, 2, 2))
   ) {
-    cig_label *clock_label = cig_memory_allocate(CIG_LABEL_SIZEOF(1));
+    /* Clock is drawn after other formatted labels, so it keeps a copy of its text */
+    cig_label *clock_label = cig_memory_allocate(CIG_LABEL_SIZEOF_TEXT(1, 8));
     clock_label->available_spans = 1;
+    clock_label->available_text = 8;
 
     cig_fill_color(get_color(COLOR_DIALOG_BACKGROUND));
     cig_draw_line(cig_v_make(CIG_SX, CIG_SY+1), cig_v_make(CIG_SX+CIG_W, CIG_SY+1), get_color(COLOR_WHITE), 1);
@@ -140,7 +142,7 @@ static void do_taskbar() {
     time_t t = time(NULL);
     struct tm *ct = localtime(&t);
 
-    cig_label_prepare(clock_label, cig_v_zero(), (cig_text_properties) { .flags = CIG_TEXT_FORMATTED }, "%02d:%02d", ct->tm_hour, ct->tm_min);
+    cig_label_prepare(clock_label, cig_v_zero(), (cig_text_properties) { .flags = CIG_TEXT_FORMATTED | CIG_TEXT_COPY }, "%02d:%02d", ct->tm_hour, ct->tm_min);
 
     const int clock_w = (clock_label->bounds.w+11*2);
 
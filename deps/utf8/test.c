@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 // english characters are 1 byte each
@@ -344,6 +345,68 @@ void test_unicode_code_point() {
   assert(unicode_code_point(next_utf8_char(&iter)) == 128513); // 😁
 }
 
+// Random mix of ASCII runs, valid characters of every length and (if invalid) random bytes,
+// long enough to go through several 16 byte blocks
+size_t random_utf8(char* out, size_t capacity, bool invalid) {
+  static const char* chars[] = { "\xC2\x80", "\xD0\xB4", "\xDF\xBF", "\xE3\x81\x93", "\xEF\xBF\xBF", "\xF0\x9F\x98\x81", "\xF7\xBF\xBF\xBF" };
+  size_t len = 0, run, i;
+
+  while (len + 32 < capacity && rand() % 24) {
+    switch (rand() % (invalid ? 3 : 2)) {
+    case 0:
+      run = rand() % 24;
+      for (i = 0; i < run; ++i) out[len++] = ' ' + rand() % 95;
+      break;
+    case 1:
+      i = rand() % 7;
+      run = strlen(chars[i]);
+      memcpy(out + len, chars[i], run);
+      len += run;
+      break;
+    default:
+      out[len++] = (char)(1 + rand() % 255);
+    }
+  }
+
+  out[len] = '\0';
+  return len;
+}
+
+void test_validate_utf8_matches_scalar() {
+  char str[1024];
+  int i;
+
+  srand(1);
+  for (i = 0; i < 20000; ++i) {
+    random_utf8(str, sizeof(str), i & 1);
+
+    const utf8_validity fast = validate_utf8(str);
+    const utf8_validity scalar = validate_utf8_scalar(str);
+    assert(fast.valid == scalar.valid);
+    assert(fast.valid_upto == scalar.valid_upto);
+  }
+}
+
+void test_utf8_char_count_matches_scalar() {
+  char str[1024];
+  int i;
+
+  srand(2);
+  for (i = 0; i < 20000; ++i) {
+    const size_t len = random_utf8(str, sizeof(str), false);
+    const utf8_string ustr = make_utf8_string(str);
+    assert(ustr.byte_len == len);
+
+    // Slices start anywhere but end on a boundary, like the ones labels measure
+    size_t start = len ? rand() % len : 0, end = start + (len - start ? rand() % (len - start + 1) : 0);
+    while (!is_utf8_char_boundary(str + end)) end++;
+    const utf8_string slice = { .str = str + start, .byte_len = end - start };
+
+    assert(utf8_char_count(ustr) == utf8_char_count_scalar(ustr));
+    assert(utf8_char_count(slice) == utf8_char_count_scalar(slice));
+  }
+}
+
 int ntests = 0;
 #define TEST(test_fn) test_fn(); ntests++; printf("%s\n", #test_fn);
 
@@ -376,6 +439,8 @@ int main() {
   TEST(test_slice_nth_utf8_char_invalid_index_err);
   TEST(test_nth_utf8_char_empty_string_err);
   TEST(test_unicode_code_point);
+  TEST(test_validate_utf8_matches_scalar);
+  TEST(test_utf8_char_count_matches_scalar);
 
   printf("\n** %d tests passed **\n", ntests);
   return 0;
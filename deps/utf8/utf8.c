@@ -3,6 +3,16 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Validation skips ASCII and counting goes through the whole string 16 bytes at a time
+// with SSE2 or NEON. Define UTF8_NO_SIMD (or CIG_NO_SIMD) to use the scalar versions only.
+#if !defined(UTF8_NO_SIMD) && !defined(CIG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define UTF8_SIMD_SSE2
+    #include <emmintrin.h>
+#elif !defined(UTF8_NO_SIMD) && !defined(CIG_NO_SIMD) && defined(__aarch64__)
+    #define UTF8_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
 #define B00000000 0
 #define B00000010 2
 #define B00000111 7
@@ -95,7 +105,7 @@ utf8_char_validity validate_utf8_char(const char* str, size_t offset) {
     return (utf8_char_validity) { .valid = false, .next_offset = offset };
 }
 
-utf8_validity validate_utf8(const char* str) {
+utf8_validity validate_utf8_scalar(const char* str) {
     if (str == NULL) return (utf8_validity) { .valid = false, .valid_upto = 0 };
 
     size_t offset = 0;
@@ -110,6 +120,44 @@ utf8_validity validate_utf8(const char* str) {
     return (utf8_validity) { .valid = true, .valid_upto = offset };
 }
 
+// Number of ASCII bytes at the start of str, up to len
+static size_t ascii_run_length(const char* str, size_t len) {
+    size_t n = 0;
+
+    // Text in other scripts rarely has 16 ASCII bytes in a row, don't load a block for every character
+    if (len == 0 || ((uint8_t)str[0] & B10000000)) return 0;
+
+#if defined(UTF8_SIMD_SSE2)
+    for (; n + 16 <= len; n += 16) {
+        if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(str + n)))) break;
+    }
+#elif defined(UTF8_SIMD_NEON)
+    for (; n + 16 <= len; n += 16) {
+        if (vmaxvq_u8(vld1q_u8((const uint8_t*)(str + n))) & B10000000) break;
+    }
+#endif
+
+    while (n < len && ((uint8_t)str[n] & B10000000) == B00000000) n++;
+    return n;
+}
+
+utf8_validity validate_utf8(const char* str) {
+    if (str == NULL) return (utf8_validity) { .valid = false, .valid_upto = 0 };
+
+    // Length is known up front so blocks are never read past the terminator
+    const size_t len = strlen(str);
+    size_t offset = 0;
+    utf8_char_validity char_validity;
+
+    while ((offset += ascii_run_length(str + offset, len - offset)) < len) {
+        char_validity = validate_utf8_char(str, offset);
+        if (char_validity.valid) offset = char_validity.next_offset;
+        else return (utf8_validity) { .valid = false, .valid_upto = offset };
+    }
+
+    return (utf8_validity) { .valid = true, .valid_upto = offset };
+}
+
 utf8_string make_utf8_string(const char* str) {
     utf8_validity validity = validate_utf8(str);
     if (validity.valid) return (utf8_string) { .str = str, .byte_len = validity.valid_upto };
@@ -246,7 +294,7 @@ utf8_char nth_utf8_char(utf8_string ustr, size_t char_index) {
     return ch;
 }
 
-size_t utf8_char_count(utf8_string ustr) {
+size_t utf8_char_count_scalar(utf8_string ustr) {
     utf8_char_iter iter = make_utf8_char_iter(ustr);
 
     size_t count = 0;
@@ -254,6 +302,48 @@ size_t utf8_char_count(utf8_string ustr) {
     return count;
 }
 
+size_t utf8_char_count(utf8_string ustr) {
+    const char* str = ustr.str;
+    const size_t len = ustr.byte_len;
+    size_t i = 0, count = 0;
+
+    if (len == 0) return 0;
+
+    // Every byte that isn't a continuation byte (10xxxxxx) starts a character. A slice that
+    // starts in the middle of one still counts it, same as iterating
+    if (!is_utf8_char_boundary(str)) count++;
+
+#if defined(UTF8_SIMD_SSE2)
+    // Continuation bytes are -128..-65 as signed. Per-lane counts are summed before they
+    // can overflow a byte
+    const __m128i last_continuation = _mm_set1_epi8((char)B10111111);
+    while (i + 16 <= len) {
+        __m128i lanes = _mm_setzero_si128();
+        const size_t end = i + 16 * 255 < len ? i + 16 * 255 : len;
+
+        for (; i + 16 <= end; i += 16) {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+            lanes = _mm_sub_epi8(lanes, _mm_cmpgt_epi8(v, last_continuation));
+        }
+
+        const __m128i sums = _mm_sad_epu8(lanes, _mm_setzero_si128());
+        count += (size_t)_mm_cvtsi128_si32(sums) + (size_t)_mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+    }
+#elif defined(UTF8_SIMD_NEON)
+    const int8x16_t last_continuation = vdupq_n_s8((int8_t)B10111111);
+    for (; i + 16 <= len; i += 16) {
+        const int8x16_t v = vld1q_s8((const int8_t*)(str + i));
+        count += vaddvq_u8(vshrq_n_u8(vcgtq_s8(v, last_continuation), 7));
+    }
+#endif
+
+    for (; i < len; ++i) {
+        if (is_utf8_char_boundary(str + i)) count++;
+    }
+
+    return count;
+}
+
 uint32_t unicode_code_point(utf8_char uchar) {
     switch (uchar.byte_len) {
     case 1: return uchar.str[0] & B01111111;
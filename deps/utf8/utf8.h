@@ -95,11 +95,18 @@ typedef struct {
 /**
  * @brief Validates whether a given string is UTF-8 compliant in O(n) time.
  *
+ * @details Runs of ASCII are skipped 16 bytes at a time where SSE2 or NEON is available.
+ *
  * @param str The input string to validate.
  * @return The validity of the UTF-8 string along with the position up to which it is valid.
  */
 utf8_validity validate_utf8(const char* str);
 
+/**
+ * @brief Same as `validate_utf8`, one character at a time. Reference for the vectorized version.
+ */
+utf8_validity validate_utf8_scalar(const char* str);
+
 /**
  * @brief Wraps a C-style string in a UTF-8 string structure after verifying its UTF-8 compliance.
  *
@@ -233,11 +240,18 @@ utf8_char nth_utf8_char(utf8_string ustr, size_t char_index);
 /**
  * @brief Counts the number of UTF-8 characters in the given utf8_string.
  *
+ * @details Counts the bytes that start a character, 16 at a time where SSE2 or NEON is available.
+ *
  * @param ustr The UTF-8 string whose characters are to be counted.
  * @return The total number of characters in the UTF-8 string.
  */
 size_t utf8_char_count(utf8_string ustr);
 
+/**
+ * @brief Same as `utf8_char_count`, iterating the characters. Reference for the vectorized version.
+ */
+size_t utf8_char_count_scalar(utf8_string ustr);
+
 /**
  * @brief Checks if a given byte is the start of a UTF-8 character. ('\0' is also a valid character boundary)
  *
@@ -2,11 +2,27 @@
 #include "cigcorem.h"
 #include <string.h>
 #include <assert.h>
+#include <limits.h>
+#ifdef CIG_PROFILE
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#endif
 
 cig__macro_ctx_st cig__macro_ctx = { 0 };
 
 static cig_context *current = NULL;
 static cig_set_clip_callback set_clip = NULL;
+static cig_input_observer_callback input_observer = NULL;
+static cig_frame_observer_callback frame_observer = NULL;
+
+#ifdef CIG_PROFILE
+static uint64_t default_profile_clock(void);
+static cig_profile_clock_callback profile_clock = &default_profile_clock;
+#endif
 
 #ifdef DEBUG
 static cig_layout_breakpoint_callback_t layout_breakpoint_callback = NULL;
@@ -25,6 +41,9 @@ static cig_r calculate_rect_in_parent(cig_r, const cig_frame*);
 static cig_r align_rect_in_parent(cig_r, cig_r, const cig_params*);
 static bool next_layout_rect(cig_r, cig_frame*, cig_r*);
 static cig_frame* push_frame(cig_r, cig_i, cig_params, bool (*)(cig_r, cig_r, cig_params*, cig_r*));
+static cig_r place_rect_in_parent(cig_r, cig_frame*);
+static cig_frame* open_frame(cig_frame*, cig_r, cig_i, cig_params, bool (*)(cig_r, cig_r, cig_params*, cig_r*));
+static void layout_rects_n(cig_r, cig_frame*, size_t, cig_r*, bool*);
 static void move_to_next_row(cig_params*);
 static void move_to_next_column(cig_params*);
 static double get_attribute_value_of_relative_to(cig_pin_attribute, cig_pin_attribute, double, cig_frame*, cig_frame*);
@@ -64,6 +83,11 @@ void cig_init_context(cig_context *context) {
   context->elapsed_time = 0.f;
   context->frames.high = 0;
   context->top_focus = NULL;
+  context->stats = (cig_stats_t) { 0 };
+#ifdef CIG_PROFILE
+  context->profile.count = 0;
+  context->profile.depth = 0;
+#endif
 
   for (i = 0; i < CIG_STATES_MAX; ++i) {
     context->state_list[i].id = 0;
@@ -90,6 +114,13 @@ void cig_begin_layout(
 ) {
   int i;
 
+  if (input_observer) {
+    input_observer(&(cig_input_event) {
+      .type = CIG_INPUT_EVENT_BEGIN_LAYOUT,
+      .layout = { rect, delta_time }
+    });
+  }
+
   current = context;
 
   current->frame_stack.clear(&current->frame_stack);
@@ -97,6 +128,10 @@ void cig_begin_layout(
   current->delta_time = delta_time;
   current->elapsed_time += delta_time;
   current->default_insets = cig_i_zero();
+  current->stats = (cig_stats_t) { 0 };
+#ifdef CIG_PROFILE
+  current->cost.count = 0;
+#endif
 
 #ifdef DEBUG
   if (requested_layout_step_mode && current->step_mode == false) {
@@ -120,6 +155,9 @@ void cig_begin_layout(
     ._parent = NULL,
     ._layout_params = (cig_params) { 0 },
     ._last_tick = current->tick,
+#ifdef CIG_PROFILE
+    ._cost = -1,
+#endif
     ._flags = OPEN
   };
   current->frame_stack.push(&current->frame_stack, &current->frames.elements[0]);
@@ -168,11 +206,14 @@ cig_end_layout()
 {
   register unsigned int i, j;
 
+  CIG_PROFILE_ZONE("cig_end_layout");
+
   for (i = 0; i < CIG_STATES_MAX; ++i) {
     if (current->state_list[i].last_tick != current->tick) {
       current->state_list[i].value.active = false;
       if (current->state_list[i].value.memory.bytes) {
         current->allocator.tracked_bytes -= current->state_list[i].value.memory.size;
+        CIG__STAT(current->stats.bytes.freed += current->state_list[i].value.memory.size)
 
         if (current->allocator.free) {
           current->allocator.free(current->allocator.ud, current->state_list[i].value.memory.bytes);
@@ -288,16 +329,98 @@ cig_frame* cig_push_layout_function(
   return push_frame(rect, insets, params, layout_function);
 }
 
+size_t cig_push_frames_n(
+  const size_t count,
+  const cig_r rect,
+  cig_frame_batch_callback callback,
+  void *user_data
+) {
+  enum { CHUNK = 64 };
+  cig_r rects[CHUNK];
+  bool valid[CHUNK], visible[CHUNK];
+  size_t i, j, n, opened = 0;
+
+  CIG_PROFILE_ZONE("cig_push_frames_n");
+
+  cig_frame *top = cig_current();
+  const cig_i insets = current->default_insets;
+
+  /*  A total limit makes the outcome of every push depend on the previous ones */
+  if (top->_layout_params.limit.total > 0) {
+    for (i = 0; i < count; ++i) {
+      cig_frame *frame = push_frame(rect, insets, (cig_params){ 0 }, NULL);
+      if (frame) {
+        if (callback) { callback(i, frame, user_data); }
+        cig_pop_frame();
+        opened ++;
+      }
+    }
+    return opened;
+  }
+
+  for (i = 0; i < count; i += n) {
+    n = M_MIN(count - i, CHUNK);
+
+    layout_rects_n(rect, top, n, rects, valid);
+
+    for (j = 0; j < n; ++j) {
+      if (valid[j]) {
+        rects[j] = place_rect_in_parent(rects[j], top);
+      }
+    }
+
+    if (!(top->_layout_params.flags & CIG_LAYOUT_DISABLE_CULLING)) {
+      const cig_r bounds = cig_r_make(-top->insets.left, -top->insets.top, top->rect.w, top->rect.h);
+
+      cig_r_intersects_n(bounds, rects, n, visible);
+
+      for (j = 0; j < n; ++j) {
+        CIG__STAT(current->stats.frames.culled += (valid[j] && !visible[j]))
+        valid[j] = valid[j] && visible[j];
+      }
+    }
+
+    for (j = 0; j < n; ++j) {
+      if (!valid[j]) {
+        top->_id_counter ++;
+        continue;
+      }
+
+      cig_frame *frame = open_frame(top, rects[j], insets, (cig_params){ 0 }, NULL);
+
+      if (frame) {
+        if (callback) { callback(i + j, frame, user_data); }
+        cig_pop_frame();
+        opened ++;
+      }
+    }
+  }
+
+  return opened;
+}
+
 cig_frame* cig_pop_frame() {
   cig_frame *popped_frame = stack_cig_frame_ref_pop(cig_frame_stack());
   popped_frame->_flags &= ~OPEN;
   if (popped_frame->_flags & CLIPPED) {
     pop_clip();
   }
+#ifdef CIG_PROFILE
+  if (popped_frame->_cost >= 0 && current->cost.entries[popped_frame->_cost].id == popped_frame->id) {
+    current->cost.entries[popped_frame->_cost].total.time = profile_clock() - current->cost.started[popped_frame->_cost];
+  }
+#endif
+  if (frame_observer) {
+    frame_observer(popped_frame, cig_frame_stack()->size);
+  }
   cig__macro_ctx.last_closed = popped_frame;
   return popped_frame;
 }
 
+void cig_assign_frame_observer(cig_frame_observer_callback fp) {
+  frame_observer = fp;
+}
+
 void cig_set_default_insets(cig_i insets) {
   current->default_insets = insets;
 }
@@ -337,6 +460,9 @@ M_OPTIONAL(void*) cig_memory_allocate(size_t bytes) {
     if (state->memory.size != bytes && current->allocator.realloc) {
       current->allocator.tracked_bytes -= state->memory.size;
       current->allocator.tracked_bytes += bytes;
+      CIG__STAT(current->stats.bytes.freed += state->memory.size)
+      CIG__STAT(current->stats.bytes.allocated += bytes)
+      CIG__COST(CIG__COST_ALLOCATED_BYTES, bytes > state->memory.size ? bytes - state->memory.size : 0)
       state->memory.bytes = current->allocator.realloc(current->allocator.ud, state->memory.bytes, state->memory.size, bytes);
       state->memory.size = bytes;
     }
@@ -345,6 +471,8 @@ M_OPTIONAL(void*) cig_memory_allocate(size_t bytes) {
   }
 
   current->allocator.tracked_bytes += bytes;
+  CIG__STAT(current->stats.bytes.allocated += bytes)
+  CIG__COST(CIG__COST_ALLOCATED_BYTES, bytes)
   state->memory.bytes = current->allocator.alloc(current->allocator.ud, bytes, ALIGN_OF(max_align_t));
   state->memory.size = bytes;
   state->memory.mapped = 0;
@@ -373,6 +501,14 @@ cig_memory_read(size_t bytes)
   return result;
 }
 
+size_t
+cig_memory_size()
+{
+  cig_state *state = enable_state();
+
+  return state && state->memory.bytes ? state->memory.size : 0;
+}
+
 void
 cig_memory_free()
 {
@@ -380,6 +516,7 @@ cig_memory_free()
 
   if (state && state->memory.bytes) {
     current->allocator.tracked_bytes -= state->memory.size;
+    CIG__STAT(current->stats.bytes.freed += state->memory.size)
 
     if (current->allocator.free) {
       current->allocator.free(current->allocator.ud, state->memory.bytes); /* Free */
@@ -424,6 +561,10 @@ void cig_pop_buffer() {
 void
 cig_set_pointer_position(cig_v position)
 {
+  if (input_observer) {
+    input_observer(&(cig_input_event) { .type = CIG_INPUT_EVENT_POINTER_POSITION, .position = position });
+  }
+
   current->input.pointer.position = position;
 
   /* Root frame has not had a hit check performed yet */
@@ -433,6 +574,10 @@ cig_set_pointer_position(cig_v position)
 void
 cig_set_pointer_state(cig_input_action_type action_mask)
 {
+  if (input_observer) {
+    input_observer(&(cig_input_event) { .type = CIG_INPUT_EVENT_POINTER_STATE, .action_mask = action_mask });
+  }
+
   /**
    * Record action mask from previous interation and update current.
    * We'll use it to compare and detect changes and generate events.
@@ -514,6 +659,10 @@ cig_set_key_state(cig_key_code key, bool pressed)
 {
   assert(key >= 0 && key < CIG__KEY_COUNT);
 
+  if (input_observer) {
+    input_observer(&(cig_input_event) { .type = CIG_INPUT_EVENT_KEY, .key = { key, pressed } });
+  }
+
   if (pressed) {
     if (!(current->input.key.code[key].state & CIG_KEY_PRESSED)) {
       current->input.key.code[key].state = CIG_KEY_PRESSED | CIG_KEY_CLICKED;
@@ -527,6 +676,10 @@ cig_set_key_state(cig_key_code key, bool pressed)
   }
 }
 
+void cig_assign_input_observer(cig_input_observer_callback fp) {
+  input_observer = fp;
+}
+
 float
 cig_set_key_repeat_rate(float rate)
 {
@@ -929,7 +1082,7 @@ cig_v cig_offset() {
 
 cig_r cig_build_rect(size_t n, cig_pin refs[]) {
   register size_t i;
-  int32_t x0, y0, x1, y1, w, h, cx, cy;
+  int32_t x0 = 0, y0 = 0, x1 = 0, y1 = 0, w = 0, h = 0, cx = 0, cy = 0;
   double a = 1;
   uint32_t attrs = 0;
   cig_pin pin;
@@ -1260,6 +1413,253 @@ float cig_delta_time() { return current->delta_time; }
 
 float cig_elapsed_time() { return current->elapsed_time; }
 
+/*  ┌────────────┐
+    │ STATISTICS │
+    └────────────┘ */
+
+cig_stats_t* cig_stats() {
+  /*  Text can be measured before the first layout, its counts go nowhere */
+  static cig_stats_t discarded;
+  return current ? &current->stats : &discarded;
+}
+
+#ifdef CIG_PROFILE
+
+/*  ┌───────────┐
+    │ PROFILING │
+    └───────────┘ */
+
+#ifdef _WIN32
+static uint64_t default_profile_clock(void) {
+  static LARGE_INTEGER frequency = { 0 };
+  LARGE_INTEGER counter;
+  if (!frequency.QuadPart) {
+    QueryPerformanceFrequency(&frequency);
+  }
+  QueryPerformanceCounter(&counter);
+  return (uint64_t)((double)counter.QuadPart * (1e9 / (double)frequency.QuadPart));
+}
+#else
+static uint64_t default_profile_clock(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+void cig_assign_profile_clock(cig_profile_clock_callback fp) {
+  profile_clock = fp ? fp : &default_profile_clock;
+}
+
+uint64_t
+cig_profile_begin(const char *name)
+{
+  if (!current) {
+    return UINT64_MAX;
+  }
+
+  const uint64_t zone = current->profile.count++;
+
+  current->profile.zones[zone % CIG_PROFILE_ZONES_MAX] = (cig_profile_zone_t) {
+    .name = name,
+    .start = profile_clock(),
+    .end = 0,
+    .depth = current->profile.depth++
+  };
+
+  return zone;
+}
+
+void
+cig_profile_end(uint64_t zone)
+{
+  if (!current || zone == UINT64_MAX) {
+    return;
+  }
+
+  current->profile.depth --;
+
+  /* Zone may have been overwritten by the time it closes */
+  if (zone + CIG_PROFILE_ZONES_MAX >= current->profile.count) {
+    current->profile.zones[zone % CIG_PROFILE_ZONES_MAX].end = profile_clock();
+  }
+}
+
+void
+cig__profile_zone_end(uint64_t *zone)
+{
+  cig_profile_end(*zone);
+}
+
+size_t
+cig_profile_zone_count(void)
+{
+  return current ? M_MIN(current->profile.count, CIG_PROFILE_ZONES_MAX) : 0;
+}
+
+const cig_profile_zone_t*
+cig_profile_zone(size_t index)
+{
+  if (!current) {
+    return NULL;
+  }
+
+  const uint64_t first = current->profile.count - cig_profile_zone_count();
+  return &current->profile.zones[(first + index) % CIG_PROFILE_ZONES_MAX];
+}
+
+void
+cig_profile_clear(void)
+{
+  if (current) {
+    current->profile.count = 0;
+  }
+}
+
+size_t
+cig_profile_write_trace(FILE *file)
+{
+  size_t i, written = 0;
+  const size_t count = cig_profile_zone_count();
+
+  fputs("{\"traceEvents\":[", file);
+
+  for (i = 0; i < count; ++i) {
+    const cig_profile_zone_t *zone = cig_profile_zone(i);
+    const char *c;
+
+    if (!zone->end) {
+      continue;
+    }
+
+    fputs(written ? ",\n{\"name\":\"" : "\n{\"name\":\"", file);
+    for (c = zone->name; *c; ++c) {
+      if (*c == '"' || *c == '\\') { fputc('\\', file); }
+      fputc(*c, file);
+    }
+    fprintf(
+      file,
+      "\",\"cat\":\"cig\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+      zone->start / 1000.0,
+      (zone->end - zone->start) / 1000.0
+    );
+
+    written ++;
+  }
+
+  fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+
+  return written;
+}
+
+void
+cig__cost_attach(cig_frame *frame, const char *name)
+{
+  cig_cost_entry_t *entries = current->cost.entries;
+
+  /* Already attributed, retaining and tagging the same frame is fine */
+  if (frame->_cost >= 0 && entries[frame->_cost].id == frame->id) {
+    if (name) { entries[frame->_cost].name = name; }
+    return;
+  }
+
+  if (current->cost.count == CIG_COST_ENTRIES_MAX) {
+    return;
+  }
+
+  const short i = current->cost.count++;
+  const short parent = frame->_cost;
+
+  entries[i] = (cig_cost_entry_t) {
+    .id = frame->id,
+    .parent = parent >= 0 ? entries[parent].id : 0,
+    .name = name,
+    .depth = parent >= 0 ? entries[parent].depth + 1 : 0
+  };
+  current->cost.parents[i] = parent;
+  current->cost.started[i] = profile_clock();
+
+  frame->_cost = i;
+}
+
+void
+cig_cost_tag(const char *name)
+{
+  cig__cost_attach(cig_current(), name);
+}
+
+void
+cig__cost_add(cig__cost_kind kind, size_t amount)
+{
+  /*  Text can be measured outside of the layout pass, even before the
+      first one */
+  if (!current || !current->frame_stack.size) {
+    return;
+  }
+
+  const short i = cig_current()->_cost;
+
+  if (i < 0) {
+    return;
+  }
+
+  switch (kind) {
+  case CIG__COST_FRAMES: current->cost.entries[i].self.frames += amount; break;
+  case CIG__COST_TEXT_MEASURES: current->cost.entries[i].self.text_measures += amount; break;
+  case CIG__COST_ALLOCATED_BYTES: current->cost.entries[i].self.allocated_bytes += amount; break;
+  }
+}
+
+static int
+compare_cost_entries(const void *a, const void *b)
+{
+  const cig_cost_entry_t *lh = a, *rh = b;
+
+  if (lh->total.time != rh->total.time) {
+    return lh->total.time > rh->total.time ? -1 : 1;
+  }
+
+  return (int)rh->total.frames - (int)lh->total.frames;
+}
+
+const cig_cost_entry_t*
+cig_cost_report(size_t *count)
+{
+  size_t i;
+  const size_t n = current->cost.count;
+  cig_cost_entry_t *report = current->cost.report;
+
+  for (i = 0; i < n; ++i) {
+    const uint64_t time = current->cost.entries[i].total.time;
+    report[i] = current->cost.entries[i];
+    report[i].total = report[i].self;
+    report[i].total.time = report[i].self.time = time;
+  }
+
+  /*  Child subtrees are always attached after their parents, so walking
+      backwards sees every child's totals before they're added upwards */
+  for (i = n; i-- > 0;) {
+    const short parent = current->cost.parents[i];
+
+    if (parent >= 0) {
+      cig_cost_t *p = &report[parent].total;
+      p->frames += report[i].total.frames;
+      p->text_measures += report[i].total.text_measures;
+      p->allocated_bytes += report[i].total.allocated_bytes;
+
+      report[parent].self.time -= M_MIN(report[parent].self.time, report[i].total.time);
+    }
+  }
+
+  qsort(report, n, sizeof(cig_cost_entry_t), &compare_cost_entries);
+
+  if (count) { *count = n; }
+
+  return report;
+}
+
+#endif
+
 
 /*  ┌───────────────────┐
     │ BACKEND CALLBACKS │
@@ -1344,10 +1744,8 @@ static cig_frame* push_frame(
   cig_params params,
   bool (*layout_function)(cig_r, cig_r, cig_params*, cig_r*)
 ) {
-  size_t i;
-  cig_frame *f;
+  CIG_PROFILE_ZONE("push_frame");
 
-  cig_buffer_element_t *current_buffer = current->buffers.peek_ref(&current->buffers, 0);
   cig_frame *top = cig_current();
 
   if (top->_layout_params.limit.total > 0 && top->_layout_params._count.total == top->_layout_params.limit.total) {
@@ -1360,6 +1758,28 @@ static cig_frame* push_frame(
     goto failure;
   }
 
+  next = place_rect_in_parent(next, top);
+
+  if (!(top->_layout_params.flags & CIG_LAYOUT_DISABLE_CULLING)
+    && !cig_r_intersects(top->rect, cig_r_offset(next, top->rect.x+top->insets.left, top->rect.y+top->insets.top))) {
+    top->_id_counter ++;
+    CIG__STAT(current->stats.frames.culled ++)
+    goto failure;
+  }
+
+  return open_frame(top, next, insets, params, layout_function);
+
+  failure:
+  if (cig__macro_ctx.open) { *cig__macro_ctx.open = NULL; }
+  cig__macro_ctx.open = NULL;
+  cig__macro_ctx.retain = 0;
+  cig__macro_ctx.last_closed = NULL;
+  return NULL;
+}
+
+/*  Grows parent's content rect to include the new child and applies the scroll
+    offset, if any. Returns the child rect as it should be placed in the parent */
+M_INLINED cig_r place_rect_in_parent(cig_r next, cig_frame *top) {
   top->content_rect = cig_r_containing(top->content_rect, next);
 
   if (top->_scroll_state) {
@@ -1371,11 +1791,21 @@ static cig_frame* push_frame(
     top->_scroll_state->bounds = cig_v_make(top->content_rect.w, top->content_rect.h);
   }
 
-  if (!(top->_layout_params.flags & CIG_LAYOUT_DISABLE_CULLING)
-    && !cig_r_intersects(top->rect, cig_r_offset(next, top->rect.x+top->insets.left, top->rect.y+top->insets.top))) {
-    top->_id_counter ++;
-    goto failure;
-  }
+  return next;
+}
+
+/*  Opens a new frame with an already laid out and culled rect */
+static cig_frame* open_frame(
+  cig_frame *top,
+  const cig_r next,
+  const cig_i insets,
+  cig_params params,
+  bool (*layout_function)(cig_r, cig_r, cig_params*, cig_r*)
+) {
+  size_t i;
+  cig_frame *f;
+
+  cig_buffer_element_t *current_buffer = current->buffers.peek_ref(&current->buffers, 0);
 
   const cig_id next_id = current->next_id
     ? current->next_id
@@ -1391,6 +1821,8 @@ static cig_frame* push_frame(
     if (f->_flags & RETAINED && f->id == next_id) {
       new_frame = f;
 
+      CIG__STAT(current->stats.frames.retained ++)
+
       if (new_frame->_last_tick != current->tick - 1) {
         previous_visibility = new_frame->visibility = 0;
       } else {
@@ -1429,7 +1861,7 @@ static cig_frame* push_frame(
   const cig_r current_clip_rect = !current_buffer->clip_rects.size
     ? current_buffer->absolute_rect
     : current_buffer->clip_rects.peek(&current_buffer->clip_rects, 0);
-  const cig_r clipped_absolute_rect = cig_r_union(absolute_rect, current_clip_rect);
+  const cig_r clipped_absolute_rect = cig_r_union_simd(absolute_rect, current_clip_rect);
 
   *new_frame = (cig_frame) {
     .id = next_id,
@@ -1443,11 +1875,17 @@ static cig_frame* push_frame(
     ._layout_params = params,
     ._parent = top,
     ._last_tick = current->tick,
+#ifdef CIG_PROFILE
+    ._cost = top->_cost,
+#endif
     ._flags = OPEN
   };
 
+  CIG__COST(CIG__COST_FRAMES, 1)
+
   current->frame_stack.push(&current->frame_stack, new_frame);
   current->next_id = 0;
+  CIG__STAT(current->stats.frames.pushed ++)
 
   if (cig__macro_ctx.open) { *cig__macro_ctx.open = new_frame; }
   if (cig__macro_ctx.retain) { M_UNUSED(cig_retain(new_frame)); }
@@ -1471,6 +1909,66 @@ static cig_frame* push_frame(
   return NULL;
 }
 
+/*  Lays out up to `n` children of the same proposed rect in one go. Stacks built
+    by the default layout builder, with a fixed item size along the stacking axis
+    and no item limit, are computed arithmetically from the first child's rect.
+    Everything else goes through the layout function for every child.
+    `valid[i]` is FALSE when the layout function refused to place the child */
+static void layout_rects_n(
+  const cig_r proposed,
+  cig_frame *top,
+  size_t n,
+  cig_r *result,
+  bool *valid
+) {
+  size_t i;
+  cig_params *prm = &top->_layout_params;
+  const bool h_axis = prm->axis & CIG_LAYOUT_AXIS_HORIZONTAL;
+  const bool v_axis = prm->axis & CIG_LAYOUT_AXIS_VERTICAL;
+
+  bool uniform = n > 1 && top->_layout_function == &cig_default_layout_builder && h_axis != v_axis;
+
+  if (uniform && h_axis) {
+    uniform = !prm->limit.horizontal
+      && !prm->_v_pos
+      && prm->alignment.horizontal == CIG_LAYOUT_ALIGNS_LEFT
+      && (CIG_IS_AUTO(proposed.w) ? (prm->width > 0 || prm->columns) : !CIG_IS_REL(proposed.w));
+  } else if (uniform && v_axis) {
+    uniform = !prm->limit.vertical
+      && !prm->_h_pos
+      && prm->alignment.vertical == CIG_LAYOUT_ALIGNS_TOP
+      && (CIG_IS_AUTO(proposed.h) ? (prm->height > 0 || prm->rows) : !CIG_IS_REL(proposed.h));
+  }
+
+  if (!uniform) {
+    for (i = 0; i < n; ++i) {
+      valid[i] = next_layout_rect(proposed, top, &result[i]);
+    }
+    return;
+  }
+
+  valid[0] = next_layout_rect(proposed, top, &result[0]);
+
+  const cig_r first = result[0];
+  const int32_t step = h_axis ? first.w + prm->spacing.x : first.h + prm->spacing.y;
+
+  for (i = 1; i < n; ++i) {
+    valid[i] = true;
+    result[i] = h_axis
+      ? cig_r_offset(first, step * (int32_t)i, 0)
+      : cig_r_offset(first, 0, step * (int32_t)i);
+  }
+
+  /* Bring layout parameters to where `n-1` more builder calls would have left them */
+  if (h_axis) {
+    prm->_h_pos += step * (int32_t)(n - 1);
+    prm->_count.h_cur += (n - 1);
+  } else {
+    prm->_v_pos += step * (int32_t)(n - 1);
+    prm->_count.v_cur += (n - 1);
+  }
+}
+
 M_INLINED void
 handle_frame_hover(cig_frame *frame)
 {
@@ -1503,6 +2001,8 @@ find_state(const cig_id id)
 {
   int i, open = -1, stale = -1;
 
+  CIG__STAT(current->stats.state.lookups ++)
+
   /* Find a state with a matching ID, with no ID yet, or a stale state */
   for (i = 0; i < CIG_STATES_MAX; ++i) {
     if (current->state_list[i].id == id) {
@@ -1520,6 +2020,8 @@ find_state(const cig_id id)
 
   const int result = open >= 0 ? open : stale;
 
+  CIG__STAT(current->stats.state.misses ++)
+
   if (result >= 0) {
     current->state_list[result].id = id;
     current->state_list[result].last_tick = current->tick;
@@ -1536,6 +2038,8 @@ find_scroll_state(const cig_id id)
 {
   int i, open = -1, stale = -1;
 
+  CIG__STAT(current->stats.scroll.lookups ++)
+
   for (i = 0; i < CIG_SCROLLABLE_ELEMENTS_MAX; ++i) {
     if (current->scroll_elements[i].id == id) {
       current->scroll_elements[i].last_tick = current->tick;
@@ -1551,6 +2055,8 @@ find_scroll_state(const cig_id id)
 
   const int result = open >= 0 ? open : stale;
 
+  CIG__STAT(current->stats.scroll.misses ++)
+
   if (result >= 0) {
     current->scroll_elements[result].id = id;
     current->scroll_elements[result].value.offset = cig_v_zero();
@@ -1567,6 +2073,8 @@ find_focus_state(const cig_id id)
 {
   int i, open = -1, stale = -1;
 
+  CIG__STAT(current->stats.focus.lookups ++)
+
   for (i = 0; i < CIG_SCROLLABLE_ELEMENTS_MAX; ++i) {
     if (current->focus_elements[i].id == id) {
       current->focus_elements[i].last_tick = current->tick;
@@ -1582,6 +2090,8 @@ find_focus_state(const cig_id id)
 
   const int result = open >= 0 ? open : stale;
 
+  CIG__STAT(current->stats.focus.misses ++)
+
   if (result >= 0) {
     current->focus_elements[result].id = id;
     current->focus_elements[result].value = (cig_focus) { 0 };
@@ -1606,11 +2116,12 @@ static void push_clip(cig_frame *frame) {
     cig_buffer_element_t *buffer_element = current->buffers.peek_ref(&current->buffers, 0);
     cig_clip_rect_t_stack_t *clip_rects = &buffer_element->clip_rects;
     /* Clip against current clip rect, or just use the absolute frame of current buffer */
-    cig_r clip_rect = cig_r_union(frame->absolute_rect, !clip_rects->size
+    cig_r clip_rect = cig_r_union_simd(frame->absolute_rect, !clip_rects->size
       ? buffer_element->absolute_rect
       : clip_rects->peek(clip_rects, 0)
     );
     clip_rects->push(clip_rects, clip_rect);
+    CIG__STAT(current->stats.clip_pushes ++)
 
     if (set_clip) {
       set_clip(cig_buffer(), clip_rect, false);
@@ -1699,6 +2210,7 @@ resolve_edge_attribute(
 
   default:
     assert(false);
+    return 0;
   }
 }
 
@@ -3,8 +3,10 @@
 
 #include "ciglimit.h"
 #include "cigkeys.h"
+#include "types/allocator.h"
 #include "types/insets.h"
 #include "types/rect.h"
+#include "types/rect_simd.h"
 #include "types/stack.h"
 #include <common/macros.h>
 #include <common/vec2.h>
@@ -20,6 +22,7 @@
 DECLARE_VEC2_T  (int32_t, cig_v)
 DECLARE_INSETS_T(int32_t, cig_i)
 DECLARE_RECT_T  (int32_t, cig_r, cig_v, cig_i)
+DECLARE_RECT_SIMD_T(cig_r, cig_v)
 
 /*  A couple of option bits we can use with rect components */
 #define CIG__AUTO_BIT M_BIT(30)
@@ -194,6 +197,9 @@ typedef struct cig_frame {
   struct cig_frame *_parent;
   cig_params _layout_params;
   unsigned int _id_counter, _last_tick;
+#ifdef CIG_PROFILE
+  short _cost;                  /* Cost entry of the closest attributed subtree, or -1 */
+#endif
   enum M_PACKED {
     /* */
     OPEN = M_BIT(0),
@@ -329,6 +335,35 @@ typedef struct {
   float key_repeat_rate;
 } cig_input_state_t;
 
+typedef enum M_PACKED {
+  CIG_INPUT_EVENT_BEGIN_LAYOUT,
+  CIG_INPUT_EVENT_POINTER_POSITION,
+  CIG_INPUT_EVENT_POINTER_STATE,
+  CIG_INPUT_EVENT_KEY
+} cig_input_event_type;
+
+/*  One call that fed input into the context, see `cig_assign_input_observer` */
+typedef struct {
+  cig_input_event_type type;
+  union {
+    struct {
+      cig_r rect;
+      float delta_time;
+    } layout;
+    cig_v position;
+    cig_input_action_type action_mask;
+    struct {
+      cig_key_code code;
+      bool pressed;
+    } key;
+  };
+} cig_input_event;
+
+typedef void (*cig_input_observer_callback)(const cig_input_event*);
+
+/*  Called with every frame as it's popped, along with its depth (root being 0) */
+typedef void (*cig_frame_observer_callback)(const cig_frame*, unsigned int);
+
 typedef enum M_PACKED {
   /*  `CIG_PRESS_INSIDE` option specifies whether the press has to start
       within the bounds of this element. Otherwise it can start outside,
@@ -392,13 +427,68 @@ DECLARE_ARRAY_STACK_T(cig_frame_ref)
 #define STACK_CAPACITY_cig_buffer_element_t CIG_BUFFERS_MAX
 DECLARE_ARRAY_STACK_T(cig_buffer_element_t)
 
+/*  Per-tick counters, see `cig_stats` */
 typedef struct {
-  void *(*alloc)  (void *ud, size_t size, size_t align);
-  void *(*realloc)(void *ud, void *ptr, size_t old_size, size_t new_size);
-  void  (*free)   (void *ud, void *ptr);
-  void *ud;
-  size_t tracked_bytes;
-} cig_allocator;
+  struct {
+    unsigned int pushed,    /* Frames opened */
+                 culled,    /* Frames rejected for being outside of their parent */
+                 retained;  /* Frames that reused a retained frame from before */
+  } frames;
+  struct {
+    unsigned int lookups,
+                 misses;    /* ID was not found and a new slot was taken (or none was free) */
+  } state, scroll, focus;
+  struct {
+    unsigned int measure_calls,       /* Calls to the measure callback */
+                 render_calls,
+                 label_cache_hits,
+                 label_cache_misses,
+                 glyph_cache_hits,    /* Text measured from cached glyph advances */
+                 glyph_cache_misses,  /* Glyphs measured to fill the cache */
+                 size_cache_hits,     /* Text sizes found in the cache */
+                 size_cache_misses,   /* Text sizes measured and stored */
+                 word_sums;           /* Slices sized from a label's measured words */
+  } text;
+  unsigned int clip_pushes;
+  struct {
+    size_t allocated,
+           freed;
+  } bytes;
+} cig_stats_t;
+
+/*  Counting statements are compiled out with CIG_DISABLE_STATS */
+#ifdef CIG_DISABLE_STATS
+  #define CIG__STAT(S)
+#else
+  #define CIG__STAT(S) S;
+#endif
+
+#ifdef CIG_PROFILE
+/*  A timed scope, see `CIG_PROFILE_ZONE` */
+typedef struct {
+  const char *name;
+  uint64_t start,   /* Nanoseconds, as returned by the profile clock */
+           end;     /* Zero while the zone is still open */
+  unsigned short depth;
+} cig_profile_zone_t;
+
+/*  Resources spent within a retained or tagged subtree during one tick */
+typedef struct {
+  unsigned int frames,          /* Frames pushed */
+               text_measures;   /* Text measure callback calls */
+  size_t allocated_bytes;       /* Element state memory allocated */
+  uint64_t time;                /* Nanoseconds, self time excludes attributed child subtrees */
+} cig_cost_t;
+
+typedef struct {
+  cig_id id,
+         parent;                /* ID of the enclosing attributed subtree, 0 if none */
+  const char *name;             /* See `cig_cost_tag`, NULL for untagged retained frames */
+  unsigned short depth;         /* Number of attributed subtrees above this one */
+  cig_cost_t self,
+             total;             /* Including all attributed subtrees within */
+} cig_cost_entry_t;
+#endif
 
 /*  A single instance of CIG. Use one for each game state?
     Should be considered an opaque type! */
@@ -433,6 +523,21 @@ typedef struct {
     size_t high;
   } frames;
   cig_focus *top_focus;
+  cig_stats_t stats;
+#ifdef CIG_PROFILE
+  struct {
+    cig_profile_zone_t zones[CIG_PROFILE_ZONES_MAX];
+    uint64_t count;   /* Total number of zones begun, ring buffer index is `count % MAX` */
+    unsigned short depth;
+  } profile;
+  struct {
+    cig_cost_entry_t entries[CIG_COST_ENTRIES_MAX],
+                     report[CIG_COST_ENTRIES_MAX];
+    short parents[CIG_COST_ENTRIES_MAX];
+    uint64_t started[CIG_COST_ENTRIES_MAX];
+    size_t count;
+  } cost;
+#endif
 #ifdef DEBUG
   bool step_mode;
 #endif
@@ -485,6 +590,10 @@ cig_frame * cig_push_layout_function(
 /*  Pop and return the last element in the layout stack */
 cig_frame* cig_pop_frame();
 
+/*  Observer sees the final rects of every frame of the tick, children before
+    their parent. Used for layout snapshots, see `cigsnapshot.h` */
+void cig_assign_frame_observer(M_OPTIONAL(cig_frame_observer_callback));
+
 /*  Sets insets used by all consecutive `cig_push_frame` calls */
 void cig_set_default_insets(cig_i);
 
@@ -520,9 +629,16 @@ cig_frame_ref_stack_t* cig_frame_stack();
     │ STATE & MEMORY ALLOCATION │
     └───────────────────────────┘ */
 
+#ifdef CIG_PROFILE
+void cig__cost_attach(cig_frame*, const char*);
+#endif
+
 M_INLINED M_OPTIONAL(cig_frame*) cig_retain(M_OPTIONAL(cig_frame*) frame) {
   if (frame) {
     frame->_flags |= RETAINED;
+#ifdef CIG_PROFILE
+    cig__cost_attach(frame, NULL);
+#endif
   }
   return frame;
 }
@@ -549,6 +665,15 @@ M_OPTIONAL(void*) cig_memory_allocate(size_t bytes);
  */
 M_OPTIONAL(void*) cig_memory_read(size_t bytes);
 
+/**
+ * @brief Size of the memory allocated for the current element
+ * 
+ * Passing this to `cig_memory_allocate` returns the memory without resizing it.
+ * 
+ * @return Size in bytes or 0 if no memory has been allocated
+ */
+size_t cig_memory_size(void);
+
 /**
  * Free memory associated with the current element
  */
@@ -597,6 +722,11 @@ cig_set_pointer_state(cig_input_action_type);
 /* Set key state (pressed or not) */
 void cig_set_key_state(cig_key_code, bool);
 
+/*  Observer is called with the arguments of every `cig_begin_layout`,
+    `cig_set_pointer_position`, `cig_set_pointer_state` and `cig_set_key_state`
+    call before they are applied. Used for recording input, see `cigrecord.h` */
+void cig_assign_input_observer(M_OPTIONAL(cig_input_observer_callback));
+
 /**
  * Sets how often the key is repeated, meaning when `CIG_KEY_REPEATED` flag is set.
  * Default: `CIG_DEFAULT_KEY_REPEAT_RATE`
@@ -780,6 +910,17 @@ cig_frame* cig_push_vstack(cig_r, cig_i, cig_params);
 
 cig_frame* cig_push_grid(cig_r, cig_i, cig_params);
 
+typedef void (*cig_frame_batch_callback)(size_t, cig_frame*, void*);
+
+/*  Pushes `count` sibling frames with the same proposed rect into the current
+    frame, which is usually a stack or a grid. Child rects are laid out and culled
+    in bulk first, then each visible child is opened, handed to the callback along
+    with its index, and popped again. Children get the same automatic IDs as they
+    would with individual `cig_push_frame` calls.
+
+    @return Number of frames that were opened */
+size_t cig_push_frames_n(size_t count, cig_r, M_OPTIONAL(cig_frame_batch_callback), void *user_data);
+
 /*  ┌─────────┐
     │ UTILITY │
     └─────────┘ */
@@ -788,6 +929,97 @@ float cig_delta_time();
 
 float cig_elapsed_time();
 
+/*  ┌────────────┐
+    │ STATISTICS │
+    └────────────┘ */
+
+/*  @return Counters collected during the current tick. They are reset in
+    `cig_begin_layout`, so copy them after `cig_end_layout` to get the totals
+    of a whole tick */
+cig_stats_t* cig_stats();
+
+/**
+ * ┌────────────────────────────────────────────────────────────────────────────────┐
+ * │ PROFILING                                                                      │
+ * │                                                                                │
+ * │ Build with CIG_PROFILE to record timed zones into a ring buffer in the         │
+ * │ context. The library itself marks frame pushes, text processing & rendering    │
+ * │ and `cig_end_layout`, and you can add your own with `CIG_PROFILE_ZONE`.        │
+ * │ Recorded zones can be exported in Chrome's trace event format, which opens in  │
+ * │ chrome://tracing, Perfetto or Speedscope.                                      │
+ * │                                                                                │
+ * │ Without CIG_PROFILE the zone macros expand to nothing.                         │
+ * └────────────────────────────────────────────────────────────────────────────────┘
+ */
+
+#ifdef CIG_PROFILE
+
+#include <stdio.h>
+
+/*  Returns a monotonic timestamp in nanoseconds */
+typedef uint64_t (*cig_profile_clock_callback)(void);
+
+/*  Replaces the default monotonic clock, for example with the one your platform layer uses */
+void cig_assign_profile_clock(cig_profile_clock_callback);
+
+/*  Opens a zone and returns a handle for `cig_profile_end`. `name` is not copied */
+uint64_t cig_profile_begin(const char *name);
+
+void cig_profile_end(uint64_t zone);
+
+/*  @return Number of zones currently stored in the ring buffer */
+size_t cig_profile_zone_count(void);
+
+/*  @return Zone at `index`, 0 being the oldest still stored, or NULL before
+    the first layout */
+const cig_profile_zone_t* cig_profile_zone(size_t index);
+
+void cig_profile_clear(void);
+
+/*  Writes stored, closed zones as Chrome trace event JSON.
+    @return Number of zones written */
+size_t cig_profile_write_trace(FILE*);
+
+void cig__profile_zone_end(uint64_t*);
+
+/*  Attributes costs of the current frame's subtree to its own entry in the cost
+    report. Retained frames are attributed automatically */
+void cig_cost_tag(const char *name);
+
+/*  Returns cost entries of the current tick sorted by total time, most expensive
+    first. Read this after `cig_end_layout` to include every subtree.
+    @count: Receives the number of entries */
+const cig_cost_entry_t* cig_cost_report(size_t *count);
+
+typedef enum {
+  CIG__COST_FRAMES,
+  CIG__COST_TEXT_MEASURES,
+  CIG__COST_ALLOCATED_BYTES
+} cig__cost_kind;
+
+void cig__cost_add(cig__cost_kind, size_t);
+
+#define CIG__COST(KIND, N) cig__cost_add(KIND, N);
+
+#define CIG__PROFILE_ZONE_VAR_(LINE) cig__profile_zone_##LINE
+#define CIG__PROFILE_ZONE_VAR(LINE) CIG__PROFILE_ZONE_VAR_(LINE)
+
+#if defined(__GNUC__) || defined(__clang__)
+/*  Times the rest of the enclosing scope */
+#define CIG_PROFILE_ZONE(NAME) \
+  uint64_t CIG__PROFILE_ZONE_VAR(__LINE__) __attribute__((cleanup(cig__profile_zone_end))) = cig_profile_begin(NAME)
+#else
+/*  Scoped zones need `cleanup` attribute support */
+#define CIG_PROFILE_ZONE(NAME)
+#endif
+
+#else
+
+#define CIG_PROFILE_ZONE(NAME)
+#define CIG__COST(KIND, N)
+
+#endif
+
 /*  ┌───────────────────┐
     │ BACKEND CALLBACKS │
     └───────────────────┘ */
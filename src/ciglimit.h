@@ -34,4 +34,40 @@
  */
 #define CIG_BUFFER_CLIP_REGIONS_MAX 8
 
+/*
+ * Number of profiling zones kept per context when built with CIG_PROFILE.
+ * Older zones are overwritten once the ring buffer is full
+ */
+#define CIG_PROFILE_ZONES_MAX 8192
+
+/*
+ * Number of retained or tagged subtrees that costs are attributed to per tick
+ * when built with CIG_PROFILE
+ */
+#define CIG_COST_ENTRIES_MAX 256
+
+/*
+ * Number of font and style pairs with cached glyph advances, for fonts that
+ * allow it. The oldest pair is replaced when a new one is needed
+ */
+#define CIG_GLYPH_CACHE_FONTS 8
+
+/*
+ * Number of measured text sizes remembered across labels and raw text. Must
+ * be a power of two. A new size replaces whatever was in its slot
+ */
+#define CIG_TEXT_SIZE_CACHE_ENTRIES 512
+
+/*
+ * Longest text, in bytes, whose size is kept in that cache. The text is kept
+ * too, so that other text with the same hash isn't given its size
+ */
+#define CIG_TEXT_SIZE_CACHE_TEXT_BYTES 32
+
+/*
+ * Number of placed spans a label hands to the batch text callback at a time.
+ * Labels with more spans are drawn in several batches
+ */
+#define CIG_TEXT_BATCH_SPANS 64
+
 #endif
@@ -0,0 +1,219 @@
+#include "cigrecord.h"
+#include <string.h>
+
+typedef enum {
+  OP_BEGIN_LAYOUT = 1,    /* x, y, w, h, delta time as 4 raw bytes */
+  OP_POINTER_POSITION,    /* dx, dy */
+  OP_POINTER_STATE,       /* action mask */
+  OP_KEY_DOWN,            /* key code */
+  OP_KEY_UP               /* key code */
+} record_op;
+
+static const unsigned char header[5] = { 'C', 'I', 'G', 'R', CIG_RECORD_VERSION };
+static cig_recorder *recording = NULL;
+
+/*  ┌──────────┐
+    │ ENCODING │
+    └──────────┘ */
+
+M_INLINED unsigned int zigzag(int v) {
+  return ((unsigned int)v << 1) ^ (unsigned int)(v >> 31);
+}
+
+M_INLINED int unzigzag(unsigned int v) {
+  return (int)(v >> 1) ^ -(int)(v & 1);
+}
+
+static size_t put_varint(unsigned char *out, unsigned int v) {
+  size_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = (v & 0x7F) | 0x80;
+    v >>= 7;
+  }
+  out[n++] = v;
+  return n;
+}
+
+static bool get_varint(cig_replay *replay, unsigned int *v) {
+  unsigned int shift = 0;
+  *v = 0;
+  while (replay->_offset < replay->size && shift < 32) {
+    const unsigned char byte = replay->bytes[replay->_offset++];
+    *v |= (unsigned int)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+    shift += 7;
+  }
+  return false;
+}
+
+M_INLINED bool get_signed(cig_replay *replay, int *v) {
+  unsigned int u;
+  if (!get_varint(replay, &u)) { return false; }
+  *v = unzigzag(u);
+  return true;
+}
+
+/*  ┌───────────┐
+    │ RECORDING │
+    └───────────┘ */
+
+static void write_bytes(const unsigned char *bytes, size_t size) {
+  recording->write(bytes, size, recording->user_data);
+  recording->bytes_written += size;
+}
+
+static void observe(const cig_input_event *event) {
+  /*  Largest record is the opcode, 4 varints and a float */
+  unsigned char record[1 + 4 * 5 + 4];
+  size_t n = 0;
+
+  switch (event->type) {
+  case CIG_INPUT_EVENT_BEGIN_LAYOUT:
+    {
+      uint32_t bits;
+      memcpy(&bits, &event->layout.delta_time, sizeof(bits));
+      record[n++] = OP_BEGIN_LAYOUT;
+      n += put_varint(&record[n], zigzag(event->layout.rect.x));
+      n += put_varint(&record[n], zigzag(event->layout.rect.y));
+      n += put_varint(&record[n], zigzag(event->layout.rect.w));
+      n += put_varint(&record[n], zigzag(event->layout.rect.h));
+      record[n++] = bits & 0xFF;
+      record[n++] = (bits >> 8) & 0xFF;
+      record[n++] = (bits >> 16) & 0xFF;
+      record[n++] = bits >> 24;
+    } break;
+
+  case CIG_INPUT_EVENT_POINTER_POSITION:
+    {
+      record[n++] = OP_POINTER_POSITION;
+      n += put_varint(&record[n], zigzag(event->position.x - recording->_pointer.x));
+      n += put_varint(&record[n], zigzag(event->position.y - recording->_pointer.y));
+      recording->_pointer = event->position;
+    } break;
+
+  case CIG_INPUT_EVENT_POINTER_STATE:
+    {
+      /*  Click detection depends on every call, even when the mask is unchanged */
+      record[n++] = OP_POINTER_STATE;
+      n += put_varint(&record[n], event->action_mask);
+    } break;
+
+  case CIG_INPUT_EVENT_KEY:
+    {
+      /*  Setting a key to the state it's already in does nothing, so most
+          platform layers that report every key on every tick cost nothing */
+      const unsigned char bit = 1 << (event->key.code % 8);
+      unsigned char *byte = &recording->_keys[event->key.code / 8];
+
+      if (!!(*byte & bit) == event->key.pressed) {
+        return;
+      }
+
+      *byte ^= bit;
+      record[n++] = event->key.pressed ? OP_KEY_DOWN : OP_KEY_UP;
+      n += put_varint(&record[n], event->key.code);
+    } break;
+  }
+
+  write_bytes(record, n);
+}
+
+void cig_record_start(cig_recorder *recorder, cig_record_write_callback write, void *user_data) {
+  *recorder = (cig_recorder) {
+    .write = write,
+    .user_data = user_data
+  };
+
+  recording = recorder;
+  write_bytes(header, sizeof(header));
+  cig_assign_input_observer(&observe);
+}
+
+void cig_record_stop() {
+  cig_assign_input_observer(NULL);
+  recording = NULL;
+}
+
+/*  ┌────────┐
+    │ REPLAY │
+    └────────┘ */
+
+bool cig_replay_init(cig_replay *replay, const void *bytes, size_t size) {
+  *replay = (cig_replay) {
+    .bytes = bytes,
+    .size = size,
+    ._offset = sizeof(header)
+  };
+
+  return size >= sizeof(header) && !memcmp(bytes, header, sizeof(header));
+}
+
+/*  Reads one input record, applying it if `apply` is set */
+static bool read_input(cig_replay *replay, bool apply) {
+  const record_op op = replay->bytes[replay->_offset++];
+  unsigned int value;
+  int dx, dy;
+
+  switch (op) {
+  case OP_POINTER_POSITION:
+    if (!get_signed(replay, &dx) || !get_signed(replay, &dy)) { return false; }
+    replay->_pointer = cig_v_make(replay->_pointer.x + dx, replay->_pointer.y + dy);
+    if (apply) { cig_set_pointer_position(replay->_pointer); }
+    return true;
+
+  case OP_POINTER_STATE:
+    if (!get_varint(replay, &value)) { return false; }
+    if (apply) { cig_set_pointer_state((cig_input_action_type)value); }
+    return true;
+
+  case OP_KEY_DOWN:
+  case OP_KEY_UP:
+    if (!get_varint(replay, &value) || value >= CIG__KEY_COUNT) { return false; }
+    if (apply) { cig_set_key_state((cig_key_code)value, op == OP_KEY_DOWN); }
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+bool cig_replay_tick(cig_replay *replay, cig_context *context, cig_buffer_ref buffer) {
+  cig_r rect;
+  uint32_t bits;
+  float delta_time;
+
+  /*  Input recorded before the first tick had no context to go to */
+  while (replay->_offset < replay->size && replay->bytes[replay->_offset] != OP_BEGIN_LAYOUT) {
+    if (!read_input(replay, false)) { return false; }
+  }
+
+  if (replay->_offset >= replay->size) {
+    return false;
+  }
+
+  replay->_offset++;
+
+  if (!get_signed(replay, &rect.x) || !get_signed(replay, &rect.y)
+   || !get_signed(replay, &rect.w) || !get_signed(replay, &rect.h)
+   || replay->_offset + 4 > replay->size) {
+    return false;
+  }
+
+  bits = (uint32_t)replay->bytes[replay->_offset]
+    | ((uint32_t)replay->bytes[replay->_offset + 1] << 8)
+    | ((uint32_t)replay->bytes[replay->_offset + 2] << 16)
+    | ((uint32_t)replay->bytes[replay->_offset + 3] << 24);
+  memcpy(&delta_time, &bits, sizeof(delta_time));
+  replay->_offset += 4;
+
+  cig_begin_layout(context, buffer, rect, delta_time);
+  replay->ticks++;
+
+  while (replay->_offset < replay->size && replay->bytes[replay->_offset] != OP_BEGIN_LAYOUT) {
+    if (!read_input(replay, true)) { return false; }
+  }
+
+  return true;
+}
@@ -0,0 +1,67 @@
+#ifndef CIG_RECORD_INCLUDED
+#define CIG_RECORD_INCLUDED
+
+#include "cigcore.h"
+
+/*  ╔═══════════════════════════════════════════════╗
+    ║ CIG INPUT RECORDING                           ║
+    ║                                               ║
+    ║ Captures everything fed into the context as a ║
+    ║ compact binary log, and feeds it back tick by ║
+    ║ tick to reproduce a session exactly           ║
+    ╚═══════════════════════════════════════════════╝ */
+
+/*  Log starts with the 4 byte magic "CIGR" and a version byte, followed by
+    records of an opcode byte and its operands. Integers are LEB128 varints,
+    signed ones zigzag encoded. Pointer positions are stored as a delta to
+    the previous position and keys only when their pressed state changes */
+#define CIG_RECORD_VERSION 1
+
+typedef void (*cig_record_write_callback)(const void *bytes, size_t size, void *user_data);
+
+typedef struct {
+  cig_record_write_callback write;
+  void *user_data;
+  size_t bytes_written;
+
+  /*_PRIVATE_*/
+  cig_v _pointer;
+  unsigned char _keys[(CIG__KEY_COUNT + 7) / 8];
+} cig_recorder;
+
+typedef struct {
+  const unsigned char *bytes;
+  size_t size;
+  unsigned int ticks;           /* Ticks replayed so far */
+
+  /*_PRIVATE_*/
+  size_t _offset;
+  cig_v _pointer;
+} cig_replay;
+
+/*  ┌───────────┐
+    │ RECORDING │
+    └───────────┘ */
+
+/*  Writes the header and starts recording through the input observer. Only
+    one recorder can be active. Start before `cig_begin_layout` so the first
+    tick is captured whole */
+void cig_record_start(cig_recorder*, cig_record_write_callback, void *user_data);
+
+void cig_record_stop(void);
+
+/*  ┌────────┐
+    │ REPLAY │
+    └────────┘ */
+
+/*  @return False if the bytes don't start with a valid header. Bytes are not copied */
+bool cig_replay_init(cig_replay*, const void *bytes, size_t size);
+
+/*  Calls `cig_begin_layout` with the next recorded tick and applies the input
+    recorded during it. Build the UI and call `cig_end_layout` as usual after.
+    Context should be in the same state it was when recording started (usually
+    freshly initialized) with the same key repeat rate.
+    @return False when the log has ended or is malformed */
+bool cig_replay_tick(cig_replay*, cig_context*, M_OPTIONAL(cig_buffer_ref));
+
+#endif
@@ -0,0 +1,102 @@
+#include "cigsnapshot.h"
+#include <string.h>
+
+typedef struct {
+  char magic[4];
+  uint32_t version,
+           record_size,
+           _reserved;
+} snapshot_header;
+
+static cig_snapshot *capturing = NULL;
+
+static void write_bytes(const void *bytes, size_t size) {
+  capturing->write(bytes, size, capturing->user_data);
+}
+
+static void observe(const cig_frame *frame, unsigned int depth) {
+  /*  Unused bytes are zeroed so identical layouts give identical files */
+  cig_snapshot_record record = { 0 };
+
+  record.id = frame->id;
+  record.parent = frame->_parent ? frame->_parent->id : 0;
+  record.rect = frame->rect;
+  record.clipped_rect = frame->clipped_rect;
+  record.absolute_rect = frame->absolute_rect;
+  record.absolute_clipped_rect = frame->absolute_clipped_rect;
+  record.content_rect = frame->content_rect;
+  record.insets = frame->insets;
+  record.depth = depth;
+  record.kind = CIG_SNAPSHOT_FRAME;
+  record.flags = frame->_flags;
+  record.visibility = frame->visibility;
+
+  write_bytes(&record, sizeof(record));
+  capturing->frames++;
+  capturing->_tick_frames++;
+}
+
+/*  ┌─────────┐
+    │ WRITING │
+    └─────────┘ */
+
+void cig_snapshot_start(cig_snapshot *snapshot, cig_snapshot_write_callback write, void *user_data) {
+  const snapshot_header header = {
+    { 'C', 'I', 'G', 'S' },
+    CIG_SNAPSHOT_VERSION,
+    sizeof(cig_snapshot_record)
+  };
+
+  *snapshot = (cig_snapshot) {
+    .write = write,
+    .user_data = user_data
+  };
+
+  capturing = snapshot;
+  write_bytes(&header, sizeof(header));
+  cig_assign_frame_observer(&observe);
+}
+
+void cig_snapshot_end_tick() {
+  cig_snapshot_record record = { 0 };
+
+  if (!capturing) {
+    return;
+  }
+
+  record.id = capturing->ticks++;
+  record.parent = capturing->_tick_frames;
+  record.kind = CIG_SNAPSHOT_TICK;
+
+  write_bytes(&record, sizeof(record));
+  capturing->_tick_frames = 0;
+}
+
+void cig_snapshot_stop() {
+  cig_assign_frame_observer(NULL);
+  capturing = NULL;
+}
+
+/*  ┌─────────┐
+    │ READING │
+    └─────────┘ */
+
+const cig_snapshot_record* cig_snapshot_records(const void *bytes, size_t size, size_t *count) {
+  snapshot_header header;
+
+  if (size < sizeof(header)) {
+    return NULL;
+  }
+
+  memcpy(&header, bytes, sizeof(header));
+
+  if (memcmp(header.magic, "CIGS", 4)
+   || header.version != CIG_SNAPSHOT_VERSION
+   || header.record_size != sizeof(cig_snapshot_record)) {
+    return NULL;
+  }
+
+  *count = (size - sizeof(header)) / sizeof(cig_snapshot_record);
+
+  return (const cig_snapshot_record*)((const char*)bytes + sizeof(header));
+}
@@ -0,0 +1,77 @@
+#ifndef CIG_SNAPSHOT_INCLUDED
+#define CIG_SNAPSHOT_INCLUDED
+
+#include "cigcore.h"
+
+/*  ╔════════════════════════════════════════════════╗
+    ║ CIG LAYOUT SNAPSHOTS                           ║
+    ║                                                ║
+    ║ Dumps the frame tree of every tick as fixed    ║
+    ║ size records, for checking that two builds lay ║
+    ║ out a (recorded) session identically           ║
+    ╚════════════════════════════════════════════════╝ */
+
+/*  File is a 16 byte header ("CIGS", version and record size as 32-bit
+    integers, 4 reserved bytes) followed by records. Each tick is its frame
+    records, children before their parent, and a closing tick record.
+    Records are written in host byte order, so a file can be mapped and
+    indexed directly on the machine that wrote it */
+#define CIG_SNAPSHOT_VERSION 1
+
+typedef enum M_PACKED {
+  CIG_SNAPSHOT_FRAME,
+  CIG_SNAPSHOT_TICK
+} cig_snapshot_record_kind;
+
+typedef struct {
+  uint64_t id,                  /* Tick index for tick records */
+           parent;              /* Parent frame ID. Frame count for tick records */
+  cig_r rect,
+        clipped_rect,
+        absolute_rect,
+        absolute_clipped_rect,
+        content_rect;
+  cig_i insets;
+  uint16_t depth;               /* Root is 0, but isn't included itself */
+  uint8_t kind,                 /* `cig_snapshot_record_kind` */
+          flags,                /* Internal frame flags: hover, clipping, interaction... */
+          visibility;
+  uint8_t _reserved[3];
+} cig_snapshot_record;
+
+typedef void (*cig_snapshot_write_callback)(const void *bytes, size_t size, void *user_data);
+
+typedef struct {
+  cig_snapshot_write_callback write;
+  void *user_data;
+  unsigned int ticks;
+  size_t frames;                /* Frames written in total */
+
+  /*_PRIVATE_*/
+  size_t _tick_frames;
+} cig_snapshot;
+
+/*  ┌─────────┐
+    │ WRITING │
+    └─────────┘ */
+
+/*  Writes the header and starts capturing popped frames. Only one snapshot
+    can be active */
+void cig_snapshot_start(cig_snapshot*, cig_snapshot_write_callback, void *user_data);
+
+/*  Closes the current tick, call after `cig_end_layout`. Tick records are
+    numbered from 0 when the snapshot starts */
+void cig_snapshot_end_tick(void);
+
+void cig_snapshot_stop(void);
+
+/*  ┌─────────┐
+    │ READING │
+    └─────────┘ */
+
+/*  @return Records of a snapshot file in memory, or NULL if it was written by
+    another version or with a different record layout.
+    @count: Receives the number of records */
+M_OPTIONAL(const cig_snapshot_record*) cig_snapshot_records(const void *bytes, size_t size, size_t *count);
+
+#endif
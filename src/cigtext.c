@@ -5,6 +5,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdarg.h>
+#include <assert.h>
+#include <limits.h>
 
 #define MAX_TAG_NAME_LEN 16
 #define MAX_TAG_VALUE_LEN 32
@@ -12,18 +14,53 @@
 #define IS_CODEPOINT_NEWLINE(CP) (CP == 0x0A)
 #define IS_CODEPOINT_SPACE(CP) (CP == 0x20)
 
+/*  Plain runs of text are skipped 16 bytes at a time where SSE2 or NEON is
+    available. Define CIG_NO_SIMD to always go byte by byte */
+#if !defined(CIG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define TEXT_SIMD_SSE2
+  #include <emmintrin.h>
+#elif !defined(CIG_NO_SIMD) && defined(__aarch64__)
+  #define TEXT_SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
 typedef struct {
-  unsigned short w, h;
+  int32_t w, h;
 } bounds_t;
 
+typedef enum {
+  MARKUP_UNKNOWN,
+  MARKUP_FONT,
+  MARKUP_COLOR,
+  MARKUP_BOLD,
+  MARKUP_ITALIC,
+  MARKUP_UNDERLINE,
+  MARKUP_STRIKETHROUGH
+} markup_kind;
+
+/*  Tag in a label's text, from '<' to past '>'. Labels drawn with
+    `cig_draw_label*` keep their tags between the spans and the text copy,
+    so laying out the same text again doesn't parse them */
 typedef struct {
-  bool opened_or_closed,
-       open,
-       terminating,
-       _naming;
-  char name[MAX_TAG_NAME_LEN],
-       value[MAX_TAG_VALUE_LEN];
-} tag_parser_t;
+  uint32_t start,
+           end;
+  unsigned char kind;
+  bool terminating;
+  uint64_t value;
+} markup_tag;
+
+/*  Word of a label's text between spaces, newlines and tags, with the
+    running sum of advances at both ends. Text between the start of one
+    word and the end of another is `x1 - x0 - letter_spacing` wide, so
+    labels that are only resized wrap again without measuring */
+typedef struct {
+  uint32_t start,
+           end;
+  int32_t x0,
+          x1;
+  int16_t height,
+          letter_spacing;
+} measured_word;
 
 typedef struct {
   bool reading;
@@ -49,7 +86,20 @@ typedef struct {
     cig_text_color_ref colors[4];
     size_t count;
   } color_stack;
-  tag_parser_t tag_parser;
+  struct {
+    const markup_tag *cached;   /* Label's tags, or NULL to parse them as they come */
+    size_t count,
+           next;                /* Index of the next cached tag */
+    markup_tag parsed;          /* Next tag when not cached */
+    size_t at;                  /* Start of the next tag, or SIZE_MAX */
+    bool boundary;              /* Current character starts a tag */
+  } tags;
+  struct {
+    const measured_word *list;  /* Label's words, or NULL to measure slices */
+    size_t count,
+           first,               /* Latest words looked up at the start and end of a slice */
+           last;
+  } words;
   span_run run;
   cig_font_info_st base_font_info;
   utf8_string utext;
@@ -62,14 +112,42 @@ typedef struct {
          line_count;
   cig_text_style style;
   const bool wrap_width;
+  bool out_of_spans;
 } scope_st;
 
+typedef struct {
+  cig_font_ref font;
+  cig_text_style style;
+  bool active,
+       cacheable;
+  int letter_spacing,
+      height;                 /* -1 until the first glyph is measured */
+  int16_t advances[256];      /* Latin-1 codepoints, -1 if not measured yet */
+} glyph_cache_t;
+
+typedef struct {
+  cig_font_ref font;
+  uint64_t hash;
+  uint32_t len;               /* 0 for unused slots */
+  cig_text_style style;
+  cig_v size;
+  char text[CIG_TEXT_SIZE_CACHE_TEXT_BYTES];  /* Compared on a hit, hashes of different text can be equal */
+} size_cache_entry_t;
+
 static cig_draw_text_callback render_callback = NULL;
+static cig_draw_text_batch_callback render_batch_callback = NULL;
 static cig_measure_text_callback measure_callback = NULL;
 static cig_query_font_callback font_query = NULL;
 static cig_font_ref default_font = 0;
 static cig_text_color_ref default_text_color = 0;
 static char printf_buf[CIG_LABEL_PRINTF_BUF_LENGTH];
+static struct {
+  glyph_cache_t fonts[CIG_GLYPH_CACHE_FONTS];
+  size_t next;                /* Slot replaced next */
+} glyph_cache;
+static size_cache_entry_t size_cache[CIG_TEXT_SIZE_CACHE_ENTRIES];
+static cig_placed_span render_batch[CIG_TEXT_BATCH_SPANS];
+static unsigned int text_cache_generation; /* Labels measure their words again when it changes */
 
 static void
 label_prepare(
@@ -92,15 +170,48 @@ label_process_string(
   const char*
 );
 
-static void render_spans(cig_span *, size_t, cig_font_ref, cig_text_color_ref, cig_text_horizontal_alignment, cig_text_vertical_alignment, bounds_t, int);
-static void wrap_text(utf8_string *, size_t, cig_v *, cig_text_overflow, cig_font_ref, cig_font_ref, cig_text_color_ref, cig_text_style, int32_t, cig_span *);
-static bool tag_parser_append(tag_parser_t*, utf8_char, uint32_t);
+static size_t
+plain_run_length(const char*, size_t, bool);
+
+static cig_label*
+label_allocate(size_t);
+
+static cig_label*
+label_layout(
+  cig_label*,
+  cig_text_properties*,
+  cig_v,
+  cig_id,
+  cig_id,
+  bool
+);
 
 static void
-scope_apply_tag(scope_st*);
+label_attach_text(
+  cig_label*,
+  cig_text_properties*,
+  const char*,
+  bool
+);
 
-static bool
-scope_process_tags(scope_st*);
+static cig_v measure_text(const char *, size_t, cig_font_ref, cig_text_style);
+static void draw_text(const char *, size_t, cig_r, cig_font_ref, cig_text_color_ref, cig_text_style);
+static void render_spans(const char *, cig_span *, size_t, cig_font_ref, cig_text_color_ref, cig_text_horizontal_alignment, cig_text_vertical_alignment, bounds_t, int);
+static void wrap_text(utf8_string *, cig_v *, cig_text_overflow, cig_font_ref, cig_font_ref, cig_text_color_ref, cig_text_style, int32_t, cig_span *);
+static bool markup_parse(const char*, size_t, size_t, markup_tag*);
+static size_t markup_tokenize(const char*, size_t, markup_tag*, size_t);
+
+static void
+scope_apply_tag(scope_st*, const markup_tag*);
+
+static void
+scope_find_tag(scope_st*);
+
+static void
+scope_consume_tag(scope_st*);
+
+static cig_v
+scope_measure(scope_st*, utf8_string, cig_font_ref, cig_text_style);
 
 static cig_span*
 scope_add_label_span(
@@ -114,6 +225,31 @@ scope_add_label_span(
   size_t
 );
 
+M_INLINED size_t
+label_size(size_t spans, size_t tags, size_t words, size_t text_bytes)
+{
+  return CIG_LABEL_SIZEOF_TEXT(spans, text_bytes) + sizeof(markup_tag) * tags + sizeof(measured_word) * words;
+}
+
+M_INLINED markup_tag*
+label_tags(cig_label *label)
+{
+  return (markup_tag *)&label->spans[label->available_spans];
+}
+
+M_INLINED measured_word*
+label_words(cig_label *label)
+{
+  return (measured_word *)(label_tags(label) + label->available_tags);
+}
+
+/*  Text copy comes after the spans, tags and words */
+M_INLINED char*
+label_text_copy(cig_label *label)
+{
+  return (char *)(label_words(label) + label->available_words);
+}
+
 /*  ┌───────────────────┐
     │ BACKEND CALLBACKS │
     └───────────────────┘ */
@@ -122,12 +258,24 @@ void cig_assign_draw_text(cig_draw_text_callback callback) {
   render_callback = callback;
 }
 
+void cig_assign_draw_text_batch(cig_draw_text_batch_callback callback) {
+  render_batch_callback = callback;
+}
+
 void cig_assign_measure_text(cig_measure_text_callback callback) {
   measure_callback = callback;
+  cig_clear_text_cache();
 }
 
 void cig_assign_query_font(cig_query_font_callback callback) {
   font_query = callback;
+  cig_clear_text_cache();
+}
+
+void cig_clear_text_cache() {
+  memset(&glyph_cache, 0, sizeof(glyph_cache));
+  memset(size_cache, 0, sizeof(size_cache));
+  text_cache_generation++;
 }
 
 /*  ┌──────────────┐
@@ -158,9 +306,10 @@ cig_draw_label(cig_text_properties props, const char *text, ...)
   register const cig_r absolute_rect = cig_r_inset(cig_absolute_rect(), cig_current()->insets);
 
   const char *str;
-  cig_label *label = cig_memory_allocate(sizeof(cig_label) + sizeof(cig_span[CIG_LABEL_SPANS_MAX]));
-  label->available_spans = CIG_LABEL_SPANS_MAX;
+  cig_label *label = label_allocate(0);
 
+  /*  Drawn right away, while the text is still valid */
+  props.flags &= ~CIG_TEXT_COPY;
   label_prepare(label, &props);
 
   if (props.flags & CIG_TEXT_FORMATTED) {
@@ -174,38 +323,84 @@ cig_draw_label(cig_text_properties props, const char *text, ...)
   }
 
   const cig_v max_bounds = cig_r_size(absolute_rect);
-  const cig_id hash = cig_hash(str) + (cig_id)props.font + CIG_TINYHASH(max_bounds.x, max_bounds.y);
+  const cig_id content = cig_hash(str);
+  const cig_id hash = content + (cig_id)props.font + CIG_TINYHASH(max_bounds.x, max_bounds.y);
+  const bool changed = label->hash != hash;
 
-  if (label->hash != hash) {
-    label->hash = hash;
-    label_reset(label, &props);
+  label_attach_text(label, &props, str, changed);
 
-    utf8_string utext = make_utf8_string(str);
+  if (changed) {
+    label = label_layout(label, &props, max_bounds, hash, content, true);
+  } else {
+    CIG__STAT(cig_stats()->text.label_cache_hits ++)
+  }
 
-    scope_st scope = (scope_st) {
-      .base_font_info = font_query(label->font),
-      .utext = utext,
-      .iter = make_utf8_char_iter(utext),
-      .line_count = 1,
-      .wrap_width = (max_bounds.x > 0) && !(props.flags & CIG_TEXT_HORIZONTAL_WRAP_DISABLED)
-    };
+  cig_label_draw(label);
+
+  return label;
+}
+
+/*  @return Bytes `text` formats to, with the terminator */
+static size_t
+formatted_size(const char *text, va_list args)
+{
+  va_list copy;
+  va_copy(copy, args);
+  const int length = vsnprintf(NULL, 0, text, copy);
+  va_end(copy);
+  return length > 0 ? (size_t)length + 1 : 1;
+}
+
+/*  Copy of a versioned label's formatted text keeps the size it has, and
+    only grows when a new version needs more. A new label gets just what
+    `text` formats to */
+static size_t
+formatted_text_room(const char *text, va_list args)
+{
+  const size_t size = cig_memory_size();
+  return size ? ((cig_label *)cig_memory_allocate(size))->available_text : formatted_size(text, args);
+}
 
-    label_process_string(label, &scope, &props, max_bounds, text);
+M_DISCARDABLE(cig_label *)
+cig_draw_label_versioned(cig_text_properties props, unsigned int version, const char *text, ...)
+{
+  register const cig_r absolute_rect = cig_r_inset(cig_absolute_rect(), cig_current()->insets);
+  const bool formatted = props.flags & CIG_TEXT_FORMATTED;
+  va_list args;
+  va_start(args, text);
+
+  /*  Formatted text can't stay in `printf_buf` while the version holds, so
+      it's kept after the spans */
+  cig_label *label = label_allocate(formatted ? formatted_text_room(text, args) : 0);
+
+  props.flags = formatted ? (props.flags | CIG_TEXT_COPY) : (props.flags & ~CIG_TEXT_COPY);
+  label_prepare(label, &props);
+
+  const cig_v max_bounds = cig_r_size(absolute_rect);
+  const cig_id content = CIG_TINYHASH((cig_id)version + 1, 5381);
+  const cig_id hash = content + (cig_id)props.font + CIG_TINYHASH(max_bounds.x, max_bounds.y);
+  const bool changed = label->hash != hash;
+
+  if (changed && formatted) {
+    const size_t needed = formatted_size(text, args);
+    if (needed > label->available_text) {
+      label = label_allocate(needed);
+    }
+    vsnprintf(label_text_copy(label), label->available_text, text, args);
   }
+  va_end(args);
 
-  if (render_callback) {
-    render_spans(
-      label->spans,
-      label->span_count,
-      label->font,
-      label->color,
-      label->alignment.horizontal,
-      label->alignment.vertical,
-      (bounds_t) { label->bounds.w, label->bounds.h },
-      label->line_spacing
-    );
+  /*  Formatted into the copy already */
+  label_attach_text(label, &props, text, changed && !formatted);
+
+  if (changed) {
+    label = label_layout(label, &props, max_bounds, hash, content, true);
+  } else {
+    CIG__STAT(cig_stats()->text.label_cache_hits ++)
   }
 
+  cig_label_draw(label);
+
   return label;
 }
 
@@ -218,6 +413,11 @@ cig_label_prepare(
   ...
 ) {
   const char *str;
+
+  /*  Caller's memory has no room for tags or words, tags are parsed and
+      slices measured during layout */
+  label->available_tags = 0;
+  label->available_words = 0;
   label_prepare(label, &props);
 
   if (props.flags & CIG_TEXT_FORMATTED) {
@@ -230,31 +430,25 @@ cig_label_prepare(
     str = text;
   }
 
-  const cig_id hash = cig_hash(str) + (cig_id)props.font + CIG_TINYHASH(max_bounds.x, max_bounds.y);
-
-  if (label->hash != hash) {
-    label->hash = hash;
-    label_reset(label, &props);
+  const cig_id content = cig_hash(str);
+  const cig_id hash = content + (cig_id)props.font + CIG_TINYHASH(max_bounds.x, max_bounds.y);
+  const bool changed = label->hash != hash;
 
-    utf8_string utext = make_utf8_string(str);
-
-    scope_st scope = (scope_st) {
-      .base_font_info = font_query(label->font),
-      .utext = utext,
-      .iter = make_utf8_char_iter(utext),
-      .line_count = 1,
-      .wrap_width = (max_bounds.x > 0) && !(props.flags & CIG_TEXT_HORIZONTAL_WRAP_DISABLED)
-    };
+  label_attach_text(label, &props, str, changed);
 
-    label_process_string(label, &scope, &props, max_bounds, text);
+  if (changed) {
+    label_layout(label, &props, max_bounds, hash, content, false);
+  } else {
+    CIG__STAT(cig_stats()->text.label_cache_hits ++)
   }
 
   return label;
 }
 
 void cig_label_draw(cig_label *label) {
-  if (render_callback) {
+  if (render_callback || render_batch_callback) {
     render_spans(
+      label->text,
       label->spans,
       label->span_count,
       label->font,
@@ -274,7 +468,7 @@ cig_v cig_measure_raw_text(
 ) {
   utf8_string utf8_str = make_utf8_string(text);
   cig_font_ref _font = font ? font : default_font;
-  return measure_callback(utf8_str.str, utf8_str.byte_len, _font, style);
+  return measure_text(utf8_str.str, utf8_str.byte_len, _font, style);
 }
 
 cig_v cig_measure_raw_text_formatted(
@@ -289,7 +483,7 @@ cig_v cig_measure_raw_text_formatted(
   va_end(args);
   utf8_string utf8_str = make_utf8_string(printf_buf);
   cig_font_ref _font = font ? font : default_font;
-  return measure_callback(utf8_str.str, utf8_str.byte_len, _font, style);
+  return measure_text(utf8_str.str, utf8_str.byte_len, _font, style);
 }
 
 void cig_draw_raw_text(
@@ -303,8 +497,8 @@ void cig_draw_raw_text(
   utf8_string utf8_str = make_utf8_string(text);
   cig_font_ref _font = font ? font : default_font;
   cig_text_color_ref _color = color ? color : default_text_color;
-  cig_v _bounds = (bounds.x || bounds.y) ? bounds : measure_callback(utf8_str.str, utf8_str.byte_len, _font, style);
-  render_callback(utf8_str.str, utf8_str.byte_len, cig_r_make(position.x, position.y, _bounds.x, _bounds.y), _font, _color, style);
+  cig_v _bounds = (bounds.x || bounds.y) ? bounds : measure_text(utf8_str.str, utf8_str.byte_len, _font, style);
+  draw_text(utf8_str.str, utf8_str.byte_len, cig_r_make(position.x, position.y, _bounds.x, _bounds.y), _font, _color, style);
 }
 
 void cig_draw_raw_text_formatted(
@@ -323,14 +517,185 @@ void cig_draw_raw_text_formatted(
   utf8_string utf8_str = make_utf8_string(printf_buf);
   cig_font_ref _font = font ? font : default_font;
   cig_text_color_ref _color = color ? color : default_text_color;
-  cig_v _bounds = (bounds.x || bounds.y) ? bounds : measure_callback(utf8_str.str, utf8_str.byte_len, _font, style);
-  render_callback(utf8_str.str, utf8_str.byte_len, cig_r_make(position.x, position.y, _bounds.x, _bounds.y), _font, _color, style);
+  cig_v _bounds = (bounds.x || bounds.y) ? bounds : measure_text(utf8_str.str, utf8_str.byte_len, _font, style);
+  draw_text(utf8_str.str, utf8_str.byte_len, cig_r_make(position.x, position.y, _bounds.x, _bounds.y), _font, _color, style);
 }
 
 /*  ┌────────────────────┐
     │ INTERNAL FUNCTIONS │
     └────────────────────┘ */
 
+M_INLINED cig_v
+backend_measure_text(const char *str, size_t len, cig_font_ref font, cig_text_style style)
+{
+  CIG__STAT(cig_stats()->text.measure_calls ++)
+  CIG__COST(CIG__COST_TEXT_MEASURES, 1)
+  return measure_callback(str, len, font, style);
+}
+
+static glyph_cache_t*
+find_glyph_cache(cig_font_ref font, cig_text_style style)
+{
+  register size_t i;
+  glyph_cache_t *cache;
+
+  for (i = 0; i < CIG_GLYPH_CACHE_FONTS; ++i) {
+    cache = &glyph_cache.fonts[i];
+    if (cache->active && cache->font == font && cache->style == style) {
+      return cache;
+    }
+  }
+
+  /*  Font is only queried once per pair, so a font that doesn't allow caching
+      costs a short scan per measure and nothing more */
+  const cig_font_info_st info = font_query ? font_query(font) : (cig_font_info_st) { 0 };
+
+  cache = &glyph_cache.fonts[glyph_cache.next];
+  glyph_cache.next = (glyph_cache.next + 1) % CIG_GLYPH_CACHE_FONTS;
+
+  *cache = (glyph_cache_t) {
+    .font = font,
+    .style = style,
+    .active = true,
+    .cacheable = info.cache_advances,
+    .letter_spacing = info.letter_spacing,
+    .height = -1
+  };
+  memset(cache->advances, -1, sizeof(cache->advances));
+
+  return cache;
+}
+
+/*  Sums cached advances, measuring glyphs that aren't cached yet one by one.
+    @return False if the text has glyphs outside Latin-1 or line breaks */
+static bool
+measure_cached(glyph_cache_t *cache, const char *str, size_t len, cig_v *size)
+{
+  register size_t i = 0, clen;
+  int32_t width = 0, glyphs = 0;
+  uint32_t cp;
+
+  while (i < len) {
+    const unsigned char c = str[i];
+
+    if (c < 0x80) {
+      cp = c;
+      clen = 1;
+    } else if ((c & 0xE0) == 0xC0 && i + 1 < len) {
+      cp = ((c & 0x1F) << 6) | (str[i + 1] & 0x3F);
+      clen = 2;
+    } else {
+      return false;
+    }
+
+    /*  Line breaks change the height, let the backend handle those */
+    if (cp > 0xFF || cp == '\n') {
+      return false;
+    }
+
+    if (cache->advances[cp] < 0) {
+      const cig_v glyph = backend_measure_text(&str[i], clen, cache->font, cache->style);
+      CIG__STAT(cig_stats()->text.glyph_cache_misses ++)
+      cache->advances[cp] = glyph.x;
+      cache->height = glyph.y;
+    }
+
+    width += cache->advances[cp];
+    glyphs ++;
+    i += clen;
+  }
+
+  *size = cig_v_make(width + (glyphs - 1) * cache->letter_spacing, cache->height);
+
+  return true;
+}
+
+M_INLINED cig_v
+measure_uncached(const char *str, size_t len, cig_font_ref font, cig_text_style style)
+{
+  cig_v size;
+  glyph_cache_t *cache = find_glyph_cache(font, style);
+
+  if (cache->cacheable && measure_cached(cache, str, len, &size)) {
+    CIG__STAT(cig_stats()->text.glyph_cache_hits ++)
+    return size;
+  }
+
+  return backend_measure_text(str, len, font, style);
+}
+
+/*  64-bit variant of `cig_hash` over a slice. It picks the slot in the size
+    cache and rules out most other text before the bytes are compared */
+M_INLINED uint64_t
+hash_slice(const char *str, size_t len)
+{
+  register uint64_t hash = 5381;
+  register size_t i;
+  for (i = 0; i < len; ++i) {
+    hash = ((hash << 5) + hash) + (unsigned char)str[i];
+  }
+  return hash;
+}
+
+/*  Same words ("File", "OK", column titles...) are measured by many labels
+    and raw text calls every tick, so sizes of short text are kept in a
+    direct mapped table keyed by font, style and the text itself */
+static cig_v
+measure_text(const char *str, size_t len, cig_font_ref font, cig_text_style style)
+{
+  if (!len) {
+    return backend_measure_text(str, len, font, style);
+  }
+
+  if (len > CIG_TEXT_SIZE_CACHE_TEXT_BYTES) {
+    return measure_uncached(str, len, font, style);
+  }
+
+  const uint64_t hash = hash_slice(str, len);
+  size_cache_entry_t *entry = &size_cache[
+    (size_t)(hash ^ (hash >> 32) ^ (uintptr_t)font ^ style) & (CIG_TEXT_SIZE_CACHE_ENTRIES - 1)
+  ];
+
+  if (entry->len == len && entry->hash == hash && entry->font == font && entry->style == style
+    && !memcmp(entry->text, str, len)) {
+    CIG__STAT(cig_stats()->text.size_cache_hits ++)
+    return entry->size;
+  }
+
+  CIG__STAT(cig_stats()->text.size_cache_misses ++)
+
+  *entry = (size_cache_entry_t) {
+    .font = font,
+    .hash = hash,
+    .len = (uint32_t)len,
+    .style = style,
+    .size = measure_uncached(str, len, font, style)
+  };
+  memcpy(entry->text, str, len);
+
+  return entry->size;
+}
+
+M_INLINED void
+draw_text(const char *str, size_t len, cig_r rect, cig_font_ref font, cig_text_color_ref color, cig_text_style style)
+{
+  CIG__STAT(cig_stats()->text.render_calls ++)
+
+  if (render_callback) {
+    render_callback(str, len, rect, font, color, style);
+  } else {
+    const cig_placed_span span = { str, len, rect, font, color, style };
+    render_batch_callback(&span, 1);
+  }
+}
+
+M_INLINED void
+draw_text_batch(const cig_placed_span *spans, size_t count)
+{
+  CIG__STAT(cig_stats()->text.render_calls ++)
+  render_batch_callback(spans, count);
+}
+
 /* For setting values from props that don't affect how spans are laid out:
     - Color
     - Horizontal & vertical alignment within parent */
@@ -352,6 +717,390 @@ label_prepare(
     : props->alignment.vertical;
 }
 
+/*  Points the label at the text its spans refer to. Unchanged text is
+    equal to what the spans were laid out from, so only the pointer is
+    updated, in case the caller's string has moved */
+static void
+label_attach_text(
+  cig_label *label,
+  cig_text_properties *props,
+  const char *str,
+  bool changed
+) {
+  if (!(props->flags & CIG_TEXT_COPY)) {
+    label->text = str;
+    return;
+  }
+
+  assert(label->available_text > 0);
+
+  char *copy = label_text_copy(label);
+
+  if (changed) {
+    /*  Text that doesn't fit is cut, the spans are laid out from the copy */
+    const size_t len = M_MIN(strlen(str), label->available_text - 1);
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+  }
+
+  label->text = copy;
+}
+
+/*  Label that takes up the current element's memory, with `text_bytes` for
+    a copy of the text after its spans. The existing label keeps its spans,
+    tags and words. Memory that can't be resized (an allocator without
+    `realloc`) keeps its size and the label takes as many spans as fit */
+static cig_label*
+label_allocate(size_t text_bytes)
+{
+  const size_t size = cig_memory_size();
+  cig_label *label;
+
+  if (size) {
+    label = cig_memory_allocate(size);
+    if (label->available_text == text_bytes
+      && size >= label_size(label->available_spans, label->available_tags, label->available_words, text_bytes)) {
+      return label;
+    }
+    label = cig_memory_allocate(CIG_LABEL_SIZEOF_TEXT(label->available_spans, text_bytes));
+    if (cig_memory_size() < CIG_LABEL_SIZEOF_TEXT(label->available_spans, text_bytes)) {
+      text_bytes = M_MIN(text_bytes, (size - CIG_LABEL_SIZEOF(1)) / 2);
+      label->available_spans = (size - CIG_LABEL_SIZEOF(0) - text_bytes) / sizeof(cig_span);
+    }
+  } else {
+    label = cig_memory_allocate(CIG_LABEL_SIZEOF_TEXT(CIG_LABEL_SPANS_INITIAL, text_bytes));
+    label->available_spans = CIG_LABEL_SPANS_INITIAL;
+  }
+
+  label->hash = 0;
+  label->markup_hash = 0;
+  label->measure_hash = 0;
+  label->available_tags = 0;
+  label->available_words = 0;
+  label->available_text = text_bytes;
+
+  return label;
+}
+
+/*  Doubles the spans of a label allocated with `label_allocate`. The copy
+    of the text is moved after the new spans.
+    @return Moved label or NULL if it's at `CIG_LABEL_SPANS_MAX` already,
+    or its memory can't be resized */
+static cig_label*
+label_grow(cig_label *label)
+{
+  const size_t spans = CIG_LABEL_SPANS_MAX
+    ? M_MIN(label->available_spans * 2, CIG_LABEL_SPANS_MAX)
+    : label->available_spans * 2;
+
+  if (spans <= label->available_spans || spans > USHRT_MAX) {
+    return NULL;
+  }
+
+  const bool copied = label->text == label_text_copy(label);
+  const size_t size = label_size(spans, label->available_tags, label->available_words, label->available_text);
+
+  label = cig_memory_allocate(size);
+  if (cig_memory_size() < size) {
+    return NULL;
+  }
+
+  memmove(
+    &label->spans[spans],
+    &label->spans[label->available_spans],
+    sizeof(markup_tag) * label->available_tags + sizeof(measured_word) * label->available_words + label->available_text
+  );
+  label->available_spans = spans;
+
+  if (copied) {
+    label->text = label_text_copy(label);
+  }
+
+  return label;
+}
+
+/*  Makes room for `count` tags, moving the words and the text copy after
+    them. Label that can't grow keeps the tags it had room for.
+    @return Moved label */
+static cig_label*
+label_reserve_tags(cig_label *label, size_t count)
+{
+  const bool copied = label->text == label_text_copy(label);
+  const size_t words_offset = sizeof(markup_tag) * label->available_tags;
+  const size_t size = label_size(label->available_spans, count, label->available_words, label->available_text);
+
+  label = cig_memory_allocate(size);
+  if (cig_memory_size() < size) {
+    return label;
+  }
+
+  memmove(
+    (char *)label_tags(label) + sizeof(markup_tag) * count,
+    (char *)label_tags(label) + words_offset,
+    sizeof(measured_word) * label->available_words + label->available_text
+  );
+  label->available_tags = count;
+
+  if (copied) {
+    label->text = label_text_copy(label);
+  }
+
+  return label;
+}
+
+/*  Makes room for `count` words, moving the text copy after them. Label
+    that can't grow keeps the words it had room for.
+    @return Moved label */
+static cig_label*
+label_reserve_words(cig_label *label, size_t count)
+{
+  const bool copied = label->text == label_text_copy(label);
+  const size_t text_offset = sizeof(measured_word) * label->available_words;
+  const size_t size = label_size(label->available_spans, label->available_tags, count, label->available_text);
+
+  label = cig_memory_allocate(size);
+  if (cig_memory_size() < size) {
+    return label;
+  }
+
+  memmove(
+    (char *)label_words(label) + sizeof(measured_word) * count,
+    (char *)label_words(label) + text_offset,
+    label->available_text
+  );
+  label->available_words = count;
+
+  if (copied) {
+    label->text = label_text_copy(label);
+  }
+
+  return label;
+}
+
+/*  Tokenizes the tags of the label's text into the label, making room for
+    them as needed. Tags of a label that can't make room are left to be
+    parsed during layout, `markup_hash` is only set when they all fit.
+    @return The label, moved if it grew */
+static cig_label*
+label_tokenize(cig_label *label, cig_id content)
+{
+  utf8_string utext;
+  size_t count;
+
+  for (;;) {
+    utext = make_utf8_string(label->text);
+    count = markup_tokenize(utext.str, utext.byte_len, label_tags(label), label->available_tags);
+
+    if (count <= label->available_tags) {
+      break;
+    }
+
+    label = label_reserve_tags(label, count);
+
+    if (count > label->available_tags) {
+      label->tag_count = 0;
+      label->markup_hash = 0;
+      return label;
+    }
+  }
+
+  label->tag_count = count;
+  label->markup_hash = content;
+
+  return label;
+}
+
+/*  Words only add up to the width of text in fonts that set
+    `cache_advances`. Kerning or advances rounded from fractions make text
+    narrower or wider than its words, so the base font and every font the
+    tags switch to must set it */
+static bool
+label_fonts_add_up(cig_label *label, size_t tag_count)
+{
+  const markup_tag *tags = label_tags(label);
+  size_t t;
+
+  if (!font_query(label->font).cache_advances) {
+    return false;
+  }
+
+  for (t = 0; t < tag_count; ++t) {
+    if (tags[t].kind == MARKUP_FONT && !tags[t].terminating
+      && !font_query((cig_font_ref)(uintptr_t)tags[t].value).cache_advances) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*  Measures the words of the label's text one by one, in the font and style
+    that the tags give them, and keeps their advances in the label. Spaces
+    are measured once per font and style. Words aren't measured when their
+    widths wouldn't add up, see `label_fonts_add_up`.
+    @return The label, moved if it grew */
+static cig_label*
+label_measure_words(cig_label *label, bool markup)
+{
+  const size_t tag_count = markup ? label->tag_count : 0;
+  size_t i, count = 1 + tag_count;
+  utf8_string utext = make_utf8_string(label->text);
+
+  if (!label_fonts_add_up(label, tag_count)) {
+    return label;
+  }
+
+  /*  Every space, newline and tag ends a word */
+  for (i = 0; i < utext.byte_len; ++i) {
+    count += utext.str[i] == ' ' || utext.str[i] == '\n';
+  }
+
+  if (count > label->available_words) {
+    label = label_reserve_words(label, count);
+    utext = make_utf8_string(label->text);
+
+    if (count > label->available_words) {
+      return label;
+    }
+  }
+
+  const markup_tag *tags = label_tags(label);
+  measured_word *words = label_words(label);
+  scope_st scope = (scope_st) { .line_count = 0 };
+  cig_font_ref font = label->font;
+  cig_text_style style = 0;
+  cig_font_info_st info = font_query(font);
+  cig_v space = measure_text(" ", 1, font, style);
+  size_t start = 0, t = 0, n = 0;
+  int32_t x = 0;
+
+  for (i = 0;; ++i) {
+    const bool at_tag = t < tag_count && i == tags[t].start;
+    const bool at_end = i == utext.byte_len;
+
+    if (!at_tag && !at_end && utext.str[i] != ' ' && utext.str[i] != '\n') {
+      continue;
+    }
+
+    const cig_v size = i > start ? measure_text(&utext.str[start], i - start, font, style) : space;
+
+    words[n] = (measured_word) {
+      .start = (uint32_t)start,
+      .end = (uint32_t)i,
+      .x0 = x,
+      .x1 = i > start ? x + size.x + info.letter_spacing : x,
+      .height = (int16_t)size.y,
+      .letter_spacing = (int16_t)info.letter_spacing
+    };
+    x = words[n++].x1;
+
+    if (at_end) {
+      break;
+    }
+
+    if (at_tag) {
+      scope_apply_tag(&scope, &tags[t]);
+      start = tags[t++].end;
+      i = start - 1;
+
+      font = scope.font_stack.count ? scope.font_stack.fonts[scope.font_stack.count-1] : label->font;
+      style = scope.style;
+      info = font_query(font);
+      space = measure_text(" ", 1, font, style);
+      continue;
+    }
+
+    if (utext.str[i] == ' ') {
+      x += space.x + info.letter_spacing;
+    }
+
+    start = i + 1;
+  }
+
+  label->word_count = n;
+
+  return label;
+}
+
+/*  Parses the text into spans after the label's hash has changed. Labels
+    that can grow keep the tags of their text until `content` changes, so
+    a new width or font only wraps the text again. When only the width has
+    changed since the latest layout, the widths of the words are kept too,
+    and lines are broken by adding them up, if the fonts allow it. Growable labels are also parsed
+    again with twice the spans until the text fits, which costs at most
+    about two parses of the final size.
+    @return The label, moved if it grew */
+static cig_label*
+label_layout(
+  cig_label *label,
+  cig_text_properties *props,
+  cig_v max_bounds,
+  cig_id hash,
+  cig_id content,
+  bool growable
+) {
+  const bool markup = !(props->flags & CIG_TEXT_PLAIN);
+  const bool wrap_width = (max_bounds.x > 0) && !(props->flags & CIG_TEXT_HORIZONTAL_WRAP_DISABLED);
+  const cig_id measure_hash = CIG_TINYHASH(content + (cig_id)(props->font ? props->font : default_font), (cig_id)markup + 1)
+    + text_cache_generation;
+  bool measured = growable && wrap_width && label->measure_hash == measure_hash;
+  cig_label *grown;
+
+  CIG__STAT(cig_stats()->text.label_cache_misses ++)
+  label->hash = hash;
+
+  if (growable && markup && label->markup_hash != content) {
+    label = label_tokenize(label, content);
+  }
+
+  if (label->measure_hash != measure_hash) {
+    label->measure_hash = measure_hash;
+    label->word_count = 0;
+  }
+
+  for (;;) {
+    label_reset(label, props);
+
+    if (measured && !label->word_count) {
+      label = label_measure_words(label, markup);
+    }
+
+    utf8_string utext = make_utf8_string(label->text);
+    const bool tokenized = growable && label->markup_hash == content;
+
+    scope_st scope = (scope_st) {
+      .base_font_info = font_query(label->font),
+      .utext = utext,
+      .iter = make_utf8_char_iter(utext),
+      .tags = {
+        .cached = tokenized ? label_tags(label) : NULL,
+        .count = tokenized ? label->tag_count : 0,
+        .at = SIZE_MAX
+      },
+      .words = {
+        .list = measured && label->word_count ? label_words(label) : NULL,
+        .count = measured ? label->word_count : 0
+      },
+      .line_count = 1,
+      .wrap_width = wrap_width
+    };
+
+    if (markup) {
+      scope_find_tag(&scope);
+    }
+
+    label_process_string(label, &scope, props, max_bounds, label->text);
+
+    if (!scope.out_of_spans || !growable || !(grown = label_grow(label))) {
+      break;
+    }
+
+    label = grown;
+  }
+
+  return label;
+}
+
 /* Resets label counters for parsing text */
 static void
 label_reset(
@@ -365,6 +1114,62 @@ label_reset(
     label->font = props->font ? props->font : default_font;
 }
 
+/* @return Number of bytes from `str`, up to `max`, that don't need any
+   handling besides being added to the current span: ASCII other than NUL,
+   newline, and space if `spaces` is set. Tags are known in advance */
+static size_t
+plain_run_length(const char *str, size_t max, bool spaces)
+{
+  const char space = spaces ? ' ' : '\n';
+  size_t n = 0;
+
+#if defined(TEXT_SIMD_SSE2)
+  const __m128i newlines = _mm_set1_epi8('\n'),
+                spaces_v = _mm_set1_epi8(space),
+                zeros = _mm_setzero_si128();
+
+  for (; n + 16 <= max; n += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)(str + n));
+    const __m128i stop = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, newlines), _mm_cmpeq_epi8(v, spaces_v)),
+      _mm_cmpeq_epi8(v, zeros)
+    );
+    /*  Sign bits are set for bytes >= 0x80. The loop below finds which
+        byte it was */
+    if (_mm_movemask_epi8(_mm_or_si128(stop, v))) {
+      break;
+    }
+  }
+#elif defined(TEXT_SIMD_NEON)
+  const uint8x16_t newlines = vdupq_n_u8('\n'),
+                   spaces_v = vdupq_n_u8(space),
+                   zeros = vdupq_n_u8(0),
+                   high = vdupq_n_u8(0x80);
+
+  for (; n + 16 <= max; n += 16) {
+    const uint8x16_t v = vld1q_u8((const uint8_t*)(str + n));
+    const uint8x16_t stop = vorrq_u8(
+      vorrq_u8(vceqq_u8(v, newlines), vceqq_u8(v, spaces_v)),
+      vorrq_u8(vceqq_u8(v, zeros), vcgeq_u8(v, high))
+    );
+
+    if (vmaxvq_u8(stop)) {
+      break;
+    }
+  }
+#endif
+
+  for (; n < max; ++n) {
+    const unsigned char c = str[n];
+
+    if (c >= 0x80 || c == 0 || c == '\n' || c == space) {
+      break;
+    }
+  }
+
+  return n;
+}
+
 /* Process single piece of text and append all created spans to the label.
    This can be called multiple times with multiple strings. */
 static void label_process_string(
@@ -374,14 +1179,24 @@ static void label_process_string(
   cig_v max_bounds,
   const char *str
 ) {
+  CIG_PROFILE_ZONE("label_process_string");
+
   while ((scope->ch = next_utf8_char(&scope->iter)).byte_len > 0 && (scope->cp = unicode_code_point(scope->ch))) {
 
     /*=================================================================
       1: Process tags
     ==================================================================*/
 
-    if (scope_process_tags(scope)) {
-      continue;
+    if ((scope->tags.boundary = scope->i == scope->tags.at)) {
+      /*  Tag ends the span being read, otherwise it's skipped */
+      if (!scope->run.reading) {
+        scope_consume_tag(scope);
+        continue;
+      }
+    }
+    else if (!scope->run.reading) {
+      scope->run.reading = true;
+      scope->run.start = scope->i;
     }
 
 
@@ -406,12 +1221,13 @@ static void label_process_string(
     const bool is_space = IS_CODEPOINT_SPACE(scope->cp);
     const bool is_end_of_string = (scope->iter.str == scope->iter.terminator);
     const bool is_terminating_span =
-      (scope->i >= scope->run.start && (is_newline || scope->tag_parser.opened_or_closed))
+      (scope->i >= scope->run.start && (is_newline || scope->tags.boundary))
       || (is_end_of_string && (scope->i = scope->utext.byte_len));
 
     if ((scope->wrap_width && is_space) || is_terminating_span) {
       /* Outta spans! */
       if (label->span_count == label->available_spans) {
+        scope->out_of_spans = true;
         break;
       }
 
@@ -445,7 +1261,7 @@ static void label_process_string(
         : (utf8_string) { .str = NULL, .byte_len = 0 };
 
       cig_v bounds = length
-        ? measure_callback(slice.str, slice.byte_len, display_font, scope->style)
+        ? scope_measure(scope, slice, display_font, scope->style)
         : cig_v_zero();
 
       // if (length) {
@@ -490,6 +1306,7 @@ static void label_process_string(
                That's the start of the new span. */
             scope->iter.str = scope->run.last_fitting.str;
             scope->i = scope->run.last_fitting.index;
+            scope->tags.boundary = false; /* Comes up again */
 
             /* Create a span based on the last fitting run */
             scope_add_label_span(
@@ -527,7 +1344,6 @@ static void label_process_string(
 
               wrap_text(
                 &slice,
-                length,
                 &bounds,
                 props->overflow,
                 display_font,
@@ -551,9 +1367,11 @@ static void label_process_string(
               );
 
               /* Add overflow marker as well */
-              if (overflow_marker.str) {
+              if (overflow_marker.offset == CIG_SPAN_ELLIPSIS) {
                 if (label->span_count < label->available_spans) {
                   label->spans[label->span_count++] = overflow_marker;
+                } else {
+                  scope->out_of_spans = true;
                 }
               }
 
@@ -593,16 +1411,72 @@ static void label_process_string(
     }
 
     iterate_next:
-    scope->i += scope->ch.byte_len;
+    if (scope->tags.boundary) {
+      scope_consume_tag(scope);
+    } else {
+      scope->i += scope->ch.byte_len;
+    }
+
+    /*  Characters that follow in the same run are only counted, up to the
+        next tag. The last one is left for the loop, which ends the span at
+        the end of string */
+    if (scope->run.reading && scope->iter.str < scope->iter.terminator) {
+      const char *limit = scope->utext.str + M_MIN(scope->utext.byte_len - 1, scope->tags.at);
+      const size_t skipped = limit > scope->iter.str
+        ? plain_run_length(scope->iter.str, limit - scope->iter.str, scope->wrap_width)
+        : 0;
+
+      scope->iter.str += skipped;
+      scope->i += skipped;
+    }
   }
 
   label->line_count = M_MAX(1, scope->line_count);
   label->bounds.h = (label->line_count * scope->base_font_info.height) + (label->line_count - 1) * label->line_spacing;
 }
 
+/*  Longest prefix of `slice` that is at most `max_width` wide, cut at a
+    character boundary. Width only grows with the prefix, so it's found by
+    bisecting the bytes with a measure per step instead of per character */
+static utf8_string
+fitting_prefix(utf8_string slice, int32_t max_width, cig_font_ref font, cig_text_style style, cig_v *bounds)
+{
+  size_t lo = 0, hi = slice.byte_len, mid;
+  cig_v size;
+
+  *bounds = cig_v_make(0, bounds->y);
+
+  for (;;) {
+    mid = lo + (hi - lo) / 2;
+
+    /*  Back to the start of the character, or past it if that's `lo` */
+    while (mid > lo && !is_utf8_char_boundary(&slice.str[mid])) {
+      mid--;
+    }
+    if (mid == lo) {
+      do {
+        mid++;
+      } while (mid < hi && !is_utf8_char_boundary(&slice.str[mid]));
+    }
+    if (mid >= hi) {
+      break;
+    }
+
+    size = measure_text(slice.str, mid, font, style);
+
+    if (size.x <= max_width) {
+      lo = mid;
+      *bounds = size;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return (utf8_string) { .str = slice.str, .byte_len = lo };
+}
+
 static void wrap_text(
   utf8_string *slice,
-  size_t text_length,
   cig_v *bounds,
   cig_text_overflow overflow_mode,
   cig_font_ref display_font,
@@ -614,21 +1488,10 @@ static void wrap_text(
 ) {
   switch (overflow_mode) {
     case CIG_TEXT_SHOW_ELLIPSIS: {
-      /* How much of the text overflows? */
-      const cig_v ellipsis_size = measure_callback("...", 3, display_font, style);
-      const double overflow = bounds->x - (max_width - ellipsis_size.x);
-      const double truncation_amount = 1.0 - (overflow / bounds->x);
-      /* This is a guesstimate and may not still fit properly */
-      int new_length = round((double)text_length * truncation_amount);
-      *slice = slice_utf8_string(*slice, 0, new_length);
-      *bounds = measure_callback(slice->str, slice->byte_len, display_font, style);
-      while (new_length > 0 && bounds->x + ellipsis_size.x > max_width) { /* Shorten even more */
-        new_length -= 1;
-        *slice = slice_utf8_string(*slice, 0, new_length);
-        *bounds = measure_callback(slice->str, slice->byte_len, display_font, style);
-      }
+      const cig_v ellipsis_size = measure_text("...", 3, display_font, style);
+      *slice = fitting_prefix(*slice, max_width - ellipsis_size.x, display_font, style, bounds);
       *additional_span = (cig_span) { 
-        .str = "...",
+        .offset = CIG_SPAN_ELLIPSIS,
         .font_override = font_override,
         .color_override = color_override,
         .bounds = { ellipsis_size.x, ellipsis_size.y },
@@ -639,17 +1502,7 @@ static void wrap_text(
     } break;
 
     case CIG_TEXT_TRUNCATE: {
-      /* How much of the text overflows? */
-      const double overflow = bounds->x - max_width;
-      const double truncation_amount = 1.0 - (overflow / bounds->x);
-      int new_length = round((double)text_length * truncation_amount);
-      *slice = slice_utf8_string(*slice, 0, new_length);
-      *bounds = measure_callback(slice->str, slice->byte_len, display_font, style);
-      while (new_length > 0 && bounds->x > max_width) { /* Shorten even more */
-        new_length -= 1;
-        *slice = slice_utf8_string(*slice, 0, new_length);
-        *bounds = measure_callback(slice->str, slice->byte_len, display_font, style);
-      }
+      *slice = fitting_prefix(*slice, max_width, display_font, style, bounds);
     } break;
 
     default: break;
@@ -657,6 +1510,7 @@ static void wrap_text(
 }
 
 static void render_spans(
+  const char *text,
   cig_span *first,
   size_t count,
   cig_font_ref base_font,
@@ -668,10 +1522,15 @@ static void render_spans(
 ) {
   if (!count) { return; }
 
+  CIG_PROFILE_ZONE("render_spans");
+
   register const cig_r absolute_rect = cig_r_inset(cig_absolute_rect(), cig_current()->insets);
   register int w, dx, dy;
   register cig_span *span, *line_start, *line_end, *last = first + (count-1);
   register const cig_font_info_st font_info = font_query(base_font);
+  cig_font_ref override_font = NULL;
+  cig_font_info_st override_font_info = font_info;
+  size_t batched = 0;
 
   static double alignment_constant[3] = { 0, 0.5, 1 };
 
@@ -685,7 +1544,9 @@ static void render_spans(
     if (span->newlines || span == last) {
       line_end = span;
 
-      if (!span->str) {
+      /*  Line with nothing but a line break. Text before a break (a closing
+          tag right before a newline) is drawn without it */
+      if (span->offset == CIG_SPAN_NO_TEXT && line_start == line_end) {
 #ifdef DEBUG
         cig_trigger_layout_breakpoint(absolute_rect, cig_r_make(absolute_rect.x, dy, absolute_rect.w, font_info.height));
 #endif
@@ -695,22 +1556,44 @@ static void render_spans(
       dx = absolute_rect.x + (int)((absolute_rect.w - w) * alignment_constant[horizontal_alignment-1]);
 
       for (span = line_start; span <= line_end; span++) {
-        cig_font_info_st span_font_info = span->font_override ? font_query(span->font_override) : font_info;
+        if (span->offset == CIG_SPAN_NO_TEXT) {
+          continue;
+        }
+
+        /*  Overrides mostly come in runs of the same font */
+        if (span->font_override && span->font_override != override_font) {
+          override_font = span->font_override;
+          override_font_info = font_query(override_font);
+        }
+
+        const cig_font_info_st span_font_info = span->font_override ? override_font_info : font_info;
         const cig_r span_rect = cig_r_make(
           dx,
           dy + (span->font_override ? ((font_info.height+font_info.baseline_offset)-(span_font_info.height+span_font_info.baseline_offset)) : 0),
           span->bounds.w,
           span->bounds.h
         );
-
-        render_callback(
-          span->str,
-          span->byte_len,
-          span_rect,
-          span->font_override ? span->font_override : base_font,
-          span->color_override ? span->color_override : base_color,
-          span->style_flags
-        );
+        const char *span_text = span->offset == CIG_SPAN_ELLIPSIS ? "..." : &text[span->offset];
+        const cig_font_ref span_font = span->font_override ? span->font_override : base_font;
+        const cig_text_color_ref span_color = span->color_override ? span->color_override : base_color;
+
+        if (render_batch_callback) {
+          render_batch[batched++] = (cig_placed_span) {
+            span_text,
+            span->byte_len,
+            span_rect,
+            span_font,
+            span_color,
+            span->style_flags
+          };
+
+          if (batched == CIG_TEXT_BATCH_SPANS) {
+            draw_text_batch(render_batch, batched);
+            batched = 0;
+          }
+        } else {
+          draw_text(span_text, span->byte_len, span_rect, span_font, span_color, span->style_flags);
+        }
 
 #ifdef DEBUG
         cig_trigger_layout_breakpoint(absolute_rect, span_rect);
@@ -729,124 +1612,173 @@ static void render_spans(
 
     span++;
   }
+
+  if (batched) {
+    draw_text_batch(render_batch, batched);
+  }
 }
 
-static bool
-tag_parser_append(tag_parser_t *this, utf8_char ch, uint32_t cp)
+/*  ┌────────┐
+    │ MARKUP │
+    └────────┘ */
+
+/*  Tag names are matched by length and then by letters, case-insensitively */
+static markup_kind
+markup_kind_of(const char *name, size_t length)
 {
-  if (!this->open) {
-    if (cp == 0x3C) { /* < */
-      this->open = true;
-      this->terminating = false;
-      this->_naming = true;
-      strcpy(this->name, "");
-      strcpy(this->value, "");
-      return (this->opened_or_closed = true);
-    }
-  } else {
-    if (cp == 0x2F) { /* / */
-      this->terminating = true;
-    }
-    else if (cp == 0x3E) { /* > */
-      this->open = false;
-      return (this->opened_or_closed = true);
-    }
-    else if (cp == 0x3D && this->_naming) { /* = */
-      this->_naming = false; /* Switch to collecting tag value */
-    }
-    else if (IS_CODEPOINT_SPACE(cp)) {
-      /* Ignore spaces */
-    }
-    else {
-      if (this->_naming) {
-        snprintf(this->name+strlen(this->name), MAX_TAG_NAME_LEN-strlen(this->name), "%.*s", (int)ch.byte_len, ch.str);
-      } else {
-        snprintf(this->value+strlen(this->value), MAX_TAG_VALUE_LEN-strlen(this->value), "%.*s", (int)ch.byte_len, ch.str);
+  switch (length) {
+    case 1:
+      switch (name[0] | 0x20) {
+        case 'b': return MARKUP_BOLD;
+        case 'i': return MARKUP_ITALIC;
+        case 'u': return MARKUP_UNDERLINE;
+        case 's': return MARKUP_STRIKETHROUGH;
       }
-    }
+      break;
+    case 3: if (!strncasecmp(name, "del", 3)) { return MARKUP_STRIKETHROUGH; } break;
+    case 4: if (!strncasecmp(name, "font", 4)) { return MARKUP_FONT; } break;
+    case 5: if (!strncasecmp(name, "color", 5)) { return MARKUP_COLOR; } break;
   }
 
-  return (this->opened_or_closed = false);
+  return MARKUP_UNKNOWN;
 }
 
-static void
-scope_apply_tag(scope_st *scope)
+/*  Finds the first tag in `text` at or after `from`. Spaces in a tag are
+    ignored, '/' anywhere makes it a closing tag and '=' separates the name
+    from the value. A tag that isn't closed runs until the end of the text
+    and has no effect.
+    @return False if there are no more tags */
+static bool
+markup_parse(const char *text, size_t from, size_t length, markup_tag *tag)
 {
-  const tag_parser_t *tag = &scope->tag_parser;
+  const char *open = from < length ? memchr(text + from, '<', length - from) : NULL;
+  char name[MAX_TAG_NAME_LEN], value[MAX_TAG_VALUE_LEN];
+  size_t i, name_length = 0, value_length = 0;
+  bool naming = true;
 
-  if (!strcasecmp(tag->name, "font")) {
-    if (tag->terminating) {
-      scope->font_stack.count--;
-    }
-    else {
-      scope->font_stack.fonts[scope->font_stack.count++] = (cig_font_ref)strtoull(tag->value, NULL, 16);
-    }
+  if (!open) {
+    return false;
   }
-  else if (!strcasecmp(tag->name, "color")) {
-    if (tag->terminating) {
-      scope->color_stack.count--;
-    }
-    else {
-      scope->color_stack.colors[scope->color_stack.count++] = (cig_text_color_ref)strtoull(tag->value, NULL, 16);
-    }
-  }
-  else if (!strcasecmp(tag->name, "b")) {
-    if (tag->terminating) {
-      scope->style &= ~CIG_TEXT_BOLD;
-    }
-    else {
-      scope->style |= CIG_TEXT_BOLD;
+
+  *tag = (markup_tag) { .start = (uint32_t)(open - text), .end = (uint32_t)length };
+
+  for (i = tag->start + 1; i < length; ++i) {
+    const char c = text[i];
+
+    if (c == '/') {
+      tag->terminating = true;
+    } else if (c == '>') {
+      tag->end = (uint32_t)(i + 1);
+      break;
+    } else if (c == '=' && naming) {
+      naming = false;
+    } else if (c == ' ') {
+      /* Ignore spaces */
+    } else if (naming) {
+      if (name_length < MAX_TAG_NAME_LEN - 1) { name[name_length++] = c; }
+    } else {
+      if (value_length < MAX_TAG_VALUE_LEN - 1) { value[value_length++] = c; }
     }
   }
-  else if (!strcasecmp(tag->name, "i")) {
-    if (tag->terminating) {
-      scope->style &= ~CIG_TEXT_ITALIC;
-    }
-    else {
-      scope->style |= CIG_TEXT_ITALIC;
-    }
+
+  if (i == length) {
+    return true;
   }
-  else if (!strcasecmp(tag->name, "u")) {
-    if (tag->terminating) {
-      scope->style &= ~CIG_TEXT_UNDERLINE;
-    }
-    else {
-      scope->style |= CIG_TEXT_UNDERLINE;
-    }
+
+  tag->kind = markup_kind_of(name, name_length);
+
+  if (!tag->terminating && (tag->kind == MARKUP_FONT || tag->kind == MARKUP_COLOR)) {
+    value[value_length] = '\0';
+    tag->value = strtoull(value, NULL, 16);
   }
-  else if (!strcasecmp(tag->name, "s") || !strcasecmp(tag->name, "del")) {
-    if (tag->terminating) {
-      scope->style &= ~CIG_TEXT_STRIKETHROUGH;
-    }
-    else {
-      scope->style |= CIG_TEXT_STRIKETHROUGH;
-    }
-  } else { /* Log warning? */ }
+
+  return true;
 }
 
-static bool
-scope_process_tags(scope_st *scope)
+/*  Writes up to `capacity` tags of `text` into `tags`.
+    @return Number of tags in the text, which may be more than `capacity` */
+static size_t
+markup_tokenize(const char *text, size_t length, markup_tag *tags, size_t capacity)
 {
-  if (tag_parser_append(&scope->tag_parser, scope->ch, scope->cp)) {
-    if (!scope->tag_parser.open) { /* Tag closed */
-      scope_apply_tag(scope);
-    }
+  markup_tag tag;
+  size_t count = 0, from = 0;
 
-    if (!scope->run.reading) {
-      scope->i += scope->ch.byte_len;
-      return true;
+  while (markup_parse(text, from, length, &tag)) {
+    if (count < capacity) {
+      tags[count] = tag;
     }
+    count++;
+    from = tag.end;
   }
-  else if (scope->tag_parser.open) {
-    scope->i += scope->ch.byte_len;
-    return true;
+
+  return count;
+}
+
+static void
+scope_apply_tag(scope_st *scope, const markup_tag *tag)
+{
+  cig_text_style style = 0;
+
+  switch (tag->kind) {
+    case MARKUP_FONT:
+      if (tag->terminating) {
+        if (scope->font_stack.count) { scope->font_stack.count--; }
+      } else if (scope->font_stack.count < sizeof(scope->font_stack.fonts) / sizeof(cig_font_ref)) {
+        scope->font_stack.fonts[scope->font_stack.count++] = (cig_font_ref)(uintptr_t)tag->value;
+      }
+      return;
+    case MARKUP_COLOR:
+      if (tag->terminating) {
+        if (scope->color_stack.count) { scope->color_stack.count--; }
+      } else if (scope->color_stack.count < sizeof(scope->color_stack.colors) / sizeof(cig_text_color_ref)) {
+        scope->color_stack.colors[scope->color_stack.count++] = (cig_text_color_ref)(uintptr_t)tag->value;
+      }
+      return;
+    case MARKUP_BOLD: style = CIG_TEXT_BOLD; break;
+    case MARKUP_ITALIC: style = CIG_TEXT_ITALIC; break;
+    case MARKUP_UNDERLINE: style = CIG_TEXT_UNDERLINE; break;
+    case MARKUP_STRIKETHROUGH: style = CIG_TEXT_STRIKETHROUGH; break;
+    default: return; /* Log warning? */
   }
-  else if (!scope->run.reading) {
-    scope->run.reading = true;
-    scope->run.start = scope->i;
+
+  if (tag->terminating) {
+    scope->style &= ~style;
+  } else {
+    scope->style |= style;
   }
+}
 
-  return false;
+/*  Looks up where the next tag starts, from the label's tags or by parsing
+    the text that follows */
+static void
+scope_find_tag(scope_st *scope)
+{
+  if (scope->tags.cached) {
+    scope->tags.at = scope->tags.next < scope->tags.count
+      ? scope->tags.cached[scope->tags.next].start
+      : SIZE_MAX;
+  } else {
+    scope->tags.at = markup_parse(scope->utext.str, scope->i, scope->utext.byte_len, &scope->tags.parsed)
+      ? scope->tags.parsed.start
+      : SIZE_MAX;
+  }
+}
+
+/*  Applies the tag at the current character and continues after it */
+static void
+scope_consume_tag(scope_st *scope)
+{
+  const markup_tag *tag = scope->tags.cached
+    ? &scope->tags.cached[scope->tags.next++]
+    : &scope->tags.parsed;
+
+  scope_apply_tag(scope, tag);
+
+  scope->i = tag->end;
+  scope->iter.str = scope->utext.str + tag->end;
+  scope->tags.boundary = false;
+
+  scope_find_tag(scope);
 }
 
 static cig_span*
@@ -861,15 +1793,16 @@ scope_add_label_span(
   size_t newline_count
 ) {
   if (label->span_count == label->available_spans) {
+    scope->out_of_spans = true;
     return NULL;
   }
 
   label->spans[label->span_count++] = (cig_span) { 
-    .str = slice.str,
+    .offset = slice.str ? (uint32_t)(slice.str - scope->utext.str) : CIG_SPAN_NO_TEXT,
     .font_override = font_override,
     .color_override = color_override,
     .bounds = { bounds.x, bounds.y },
-    .byte_len = (unsigned short)slice.byte_len,
+    .byte_len = (uint32_t)slice.byte_len,
     .style_flags = style,
     .newlines = newline_count
   };
@@ -885,3 +1818,59 @@ scope_add_label_span(
 
   return &label->spans[label->span_count-1];
 }
+
+/*  Word of the label that ends at `end`, or the one after it. Slices are
+    mostly looked up in order, so a few words from `hint` on are tried before
+    searching all of them */
+M_INLINED const measured_word*
+scope_find_word(scope_st *scope, size_t end, size_t *hint)
+{
+  const measured_word *list = scope->words.list;
+  size_t lo = 0, hi = scope->words.count, i;
+
+  for (i = *hint; i < hi && i < *hint + 8; ++i) {
+    if (list[i].end >= end) {
+      if (i == 0 || list[i-1].end < end) {
+        *hint = i;
+        return &list[i];
+      }
+      break;
+    }
+  }
+
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (list[mid].end < end) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  if (lo == scope->words.count) {
+    return NULL;
+  }
+
+  *hint = lo;
+
+  return &list[lo];
+}
+
+/*  Size of a slice of the text. Slices from the start of a word to the end
+    of another are added up from the label's words, others are measured */
+static cig_v
+scope_measure(scope_st *scope, utf8_string slice, cig_font_ref font, cig_text_style style)
+{
+  if (scope->words.list) {
+    const size_t start = slice.str - scope->utext.str;
+    const measured_word *first = scope_find_word(scope, start, &scope->words.first),
+                        *last = scope_find_word(scope, start + slice.byte_len, &scope->words.last);
+
+    if (first && last && first->start == start && last->end == start + slice.byte_len) {
+      CIG__STAT(cig_stats()->text.word_sums ++)
+      return cig_v_make(last->x1 - first->x0 - last->letter_spacing, M_MAX(first->height, last->height));
+    }
+  }
+
+  return measure_text(slice.str, slice.byte_len, font, style);
+}
@@ -3,9 +3,15 @@
 
 #include "cigcore.h"
 
-#define CIG_LABEL_SPANS_MAX 48
+/*  Labels drawn with `cig_draw_label` start with this many spans and double
+    them when they run out, up to `CIG_LABEL_SPANS_MAX` if it's not 0 */
+#define CIG_LABEL_SPANS_INITIAL 4
+#ifndef CIG_LABEL_SPANS_MAX
+#define CIG_LABEL_SPANS_MAX 0
+#endif
 #define CIG_LABEL_PRINTF_BUF_LENGTH 4096
 #define CIG_LABEL_SIZEOF(NUM_SPANS) (sizeof(cig_label) + sizeof(cig_span[NUM_SPANS]))
+#define CIG_LABEL_SIZEOF_TEXT(NUM_SPANS, TEXT_BYTES) (CIG_LABEL_SIZEOF(NUM_SPANS) + (TEXT_BYTES))
 #define CIG_RAW_TEXT_AUTOMATIC_SIZE cig_v_zero()
 
 typedef void* cig_font_ref;
@@ -14,6 +20,12 @@ typedef void* cig_text_color_ref;
 typedef struct {
   int height,
       baseline_offset;
+  /*  Set if the width of any text is the sum of its glyph advances plus
+      `letter_spacing` between glyphs (no kerning), and its height doesn't
+      depend on the text. Text is then measured from cached advances of
+      Latin-1 glyphs, and the backend only measures each glyph once */
+  bool cache_advances;
+  int letter_spacing;
 } cig_font_info_st;
 
 #define CIG_TEXT_ALIGN_DEFAULT 0
@@ -55,7 +67,13 @@ typedef struct {
   cig_text_overflow overflow;
   enum M_PACKED {
     CIG_TEXT_FORMATTED = M_BIT(0),
-    CIG_TEXT_HORIZONTAL_WRAP_DISABLED = M_BIT(1)
+    CIG_TEXT_HORIZONTAL_WRAP_DISABLED = M_BIT(1),
+    /*  Prepared label keeps a copy of its text after the spans, so it can be
+        drawn after the string (or the format buffer) has changed. The label
+        must have `available_text` bytes, see `CIG_LABEL_SIZEOF_TEXT` */
+    CIG_TEXT_COPY = M_BIT(2),
+    /*  Text is shown as is, without parsing tags */
+    CIG_TEXT_PLAIN = M_BIT(3)
   } flags;
   cig_text_style style;
 } cig_text_properties;
@@ -65,12 +83,15 @@ typedef struct {
  * the horizontal bounds of the label, or until some property of the
  * text changes (font, color, link etc.)
  */
+#define CIG_SPAN_NO_TEXT UINT32_MAX        /* Span only ends a line */
+#define CIG_SPAN_ELLIPSIS (UINT32_MAX - 1)  /* Span is the "..." of truncated text */
+
 typedef struct {
-  const char *str;
   M_OPTIONAL(cig_font_ref) font_override;
   M_OPTIONAL(cig_text_color_ref) color_override;
-  struct { unsigned short w, h; } bounds;
-  unsigned short byte_len;
+  struct { int32_t w, h; } bounds;
+  uint32_t offset;                          /* Byte offset in the label's text */
+  uint32_t byte_len;                        /* Paragraphs of a text view can be megabytes long */
   unsigned char style_flags;
   unsigned char newlines;
 } cig_span;
@@ -81,17 +102,36 @@ typedef struct {
     cig_text_vertical_alignment vertical;
   } alignment;
   cig_id hash;
+  const char *text;         /* Text of the latest prepare or draw call, or the label's copy */
   cig_font_ref font;
   cig_text_color_ref color;
-  struct { unsigned short w, h; } bounds;
-  size_t available_spans;
+  struct { int32_t w, h; } bounds;
+  cig_id markup_hash;       /* Content the tags were tokenized from */
+  cig_id measure_hash;      /* Content, font and style of the latest layout */
+  size_t available_spans,
+         available_tags,    /* Tokenized tags kept after the spans, 0 for prepared labels */
+         available_words,   /* Word widths kept after the tags, for wrapping at a new width */
+         available_text,    /* Bytes reserved after the spans (tags and words) for `CIG_TEXT_COPY` */
+         tag_count,
+         word_count;
   unsigned short span_count;
   unsigned short line_count;
   char line_spacing;
   cig_span spans[];
 } cig_label;
 
+/*  Span of a label placed on screen, see `cig_assign_draw_text_batch` */
+typedef struct {
+  const char *str;
+  size_t len;
+  cig_r rect;
+  cig_font_ref font;
+  cig_text_color_ref color;
+  cig_text_style style;
+} cig_placed_span;
+
 typedef void (*cig_draw_text_callback)(const char *, size_t, cig_r, cig_font_ref, cig_text_color_ref, cig_text_style);
+typedef void (*cig_draw_text_batch_callback)(const cig_placed_span *, size_t);
 typedef cig_v (*cig_measure_text_callback)(const char *, size_t, cig_font_ref, cig_text_style);
 typedef cig_font_info_st (*cig_query_font_callback)(cig_font_ref);
 
@@ -103,10 +143,21 @@ typedef cig_font_info_st (*cig_query_font_callback)(cig_font_ref);
 
 void cig_assign_draw_text(cig_draw_text_callback);
 
+/*  Optional. Labels then hand their spans to this callback in order, already
+    positioned, up to `CIG_TEXT_BATCH_SPANS` at a time, so a backend can fill
+    one vertex buffer per label instead of drawing each span. The draw text
+    callback is used while this isn't assigned, and for raw text if it is */
+void cig_assign_draw_text_batch(cig_draw_text_batch_callback);
+
 void cig_assign_measure_text(cig_measure_text_callback);
 
 void cig_assign_query_font(cig_query_font_callback);
 
+/*  Forgets cached text sizes and glyph advances. Assigning a measure or query
+    callback does this too, call it when a font behind an existing reference
+    changes */
+void cig_clear_text_cache(void);
+
 /*
  * ┌──────────────┐
  * │ TEXT DISPLAY │
@@ -122,15 +173,26 @@ cig_font_info(cig_font_ref);
 
 /*
  * Allocates a label type in the current element's state, prepares it and
- * draws it. Label is cached based on the input string hash.
+ * draws it. Label is cached based on the input string hash. Its spans start
+ * small and grow with the text.
  */
 M_DISCARDABLE(cig_label *) cig_draw_label(cig_text_properties, const char *, ...);
 
+/*
+ * Same as `cig_draw_label`, but the text is only formatted and parsed again
+ * when `version` (or the font or bounds) changes. Bump the version whenever
+ * the text changes. Formatted text is copied into the label, unformatted text
+ * is drawn from the string passed in.
+ */
+M_DISCARDABLE(cig_label *) cig_draw_label_versioned(cig_text_properties, unsigned int version, const char *, ...);
+
 /*
  * For more advanced text display you can prepare a piece of text.
  * This enables accessing the text bounds before rendering it to
  * pass as a size for the next layout frame for example. It also exposes
- * the underlying spans (smallest text components)
+ * the underlying spans (smallest text components). Spans refer to the
+ * text passed in, which must stay valid until the label is drawn, unless
+ * the label copies it (`CIG_TEXT_COPY`).
  */
 cig_label * cig_label_prepare(cig_label *, cig_v, cig_text_properties, const char *, ...);
 
@@ -0,0 +1,355 @@
+#include "cigtextview.h"
+#include "cigcorem.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NO_LINE SIZE_MAX
+
+M_INLINED int32_t
+height_of(const cig_text_view *view, const cig_text_paragraph *p)
+{
+  return p->height < 0 ? view->_line_height : p->height;
+}
+
+/*  Adds (1) or removes (-1) a paragraph from the content height */
+M_INLINED void
+account(cig_text_view *view, const cig_text_paragraph *p, int sign)
+{
+  if (p->height < 0) {
+    view->_unmeasured += sign;
+  } else {
+    view->_measured_height += sign * p->height;
+  }
+}
+
+M_INLINED cig_text_paragraph*
+paragraph(const cig_text_view *view, size_t index)
+{
+  return (cig_text_paragraph*)fenwick_tree_item(&view->_heights, index);
+}
+
+M_INLINED cig_allocator*
+allocator_of(const cig_text_view *view)
+{
+  return view->table ? view->table->allocator : view->buffer->allocator;
+}
+
+M_INLINED cig_text_paragraph
+new_paragraph(cig_text_view *view)
+{
+  return (cig_text_paragraph) {
+    .height = -1,
+    .version = view->_next_version++
+  };
+}
+
+/*  Replaces paragraphs [index, index + removed) with `added` new ones that
+    haven't been measured yet. The line index has been updated already.
+    @return False if there was no memory for more paragraphs, nothing
+    changed then */
+static bool
+splice_paragraphs(cig_text_view *view, size_t index, size_t removed, size_t added)
+{
+  size_t i;
+
+  /*  Paragraphs are the items of their heights and shift along with them */
+  if (added > removed && !fenwick_tree_insert(&view->_heights, index + removed, added - removed)) {
+    return false;
+  }
+
+  for (i = index; i < index + removed; ++i) {
+    account(view, paragraph(view, i), -1);
+  }
+
+  if (removed > added) {
+    fenwick_tree_remove(&view->_heights, index + added, removed - added);
+  }
+
+  for (i = index; i < index + added; ++i) {
+    *paragraph(view, i) = new_paragraph(view);
+    fenwick_tree_set(&view->_heights, i, view->_line_height);
+  }
+  view->_unmeasured += added;
+
+  return true;
+}
+
+/*  ┌────────────────┐
+    │ INITIALIZATION │
+    └────────────────┘ */
+
+/*  Sets up paragraphs for the lines indexed into `view->_lines`. Lines there's
+    no memory for paragraphs for are joined into the last one that has one */
+static void
+init_paragraphs(cig_text_view *view)
+{
+  cig_text_paragraph *p;
+  size_t i;
+
+  view->_heights.item_size = sizeof(cig_text_paragraph);
+
+  for (i = 0; i < view->_lines.count; ++i) {
+    if (!(p = (cig_text_paragraph*)fenwick_tree_push(&view->_heights, 0))) {
+      if (i) {
+        line_index_join(&view->_lines, i - 1, view->_lines.count - i);
+      }
+      break;
+    }
+    *p = new_paragraph(view);
+  }
+
+  view->_unmeasured = view->_heights.count;
+  fenwick_tree_rebuild(&view->_heights);
+}
+
+void
+cig_text_view_init(cig_text_view *view, gap_buffer_char *buffer)
+{
+  *view = (cig_text_view) {
+    .buffer = buffer,
+    ._next_version = 1,
+    ._scroll_to = NO_LINE
+  };
+
+  view->_lines.allocator = view->_heights.allocator = buffer->allocator;
+  if (gap_buffer_char_index_lines(buffer, &view->_lines)) {
+    init_paragraphs(view);
+  }
+}
+
+void
+cig_text_view_init_piece_table(cig_text_view *view, piece_table_char *table)
+{
+  *view = (cig_text_view) {
+    .table = table,
+    ._next_version = 1,
+    ._scroll_to = NO_LINE
+  };
+
+  view->_lines.allocator = view->_heights.allocator = table->allocator;
+  if (piece_table_char_index_lines(table, &view->_lines)) {
+    init_paragraphs(view);
+  }
+}
+
+void
+cig_text_view_free(cig_text_view *view)
+{
+  if (view->buffer && view->buffer->lines == &view->_lines) {
+    view->buffer->lines = NULL;
+  }
+  if (view->table && view->table->lines == &view->_lines) {
+    view->table->lines = NULL;
+  }
+
+  fenwick_tree_free(&view->_lines);
+  fenwick_tree_free(&view->_heights);
+  cig_allocator_release(allocator_of(view), view->_scratch, view->_scratch_capacity);
+  view->_scratch = NULL;
+  view->_scratch_capacity = 0;
+}
+
+size_t
+cig_text_view_paragraph_count(const cig_text_view *view)
+{
+  return view->_lines.count;
+}
+
+/*  ┌─────────┐
+    │ EDITING │
+    └─────────┘ */
+
+void
+cig_text_view_insert(cig_text_view *view, size_t position, size_t count, const char text[])
+{
+  const size_t lines = view->_lines.count;
+  const size_t line = line_index_find(&view->_lines, position);
+  size_t added;
+
+  if (!count) {
+    return;
+  }
+
+  if (view->table) {
+    piece_table_char_insert(view->table, position, count, text);
+  } else {
+    gap_buffer_char_insert(&view->buffer, position, count, text);
+  }
+
+  /*  Without an index there are no paragraphs to update */
+  if (!lines) {
+    return;
+  }
+
+  /*  Stays one paragraph and keeps its height until it's drawn again. So do
+      new lines there's no memory for */
+  if (!(added = view->_lines.count - lines) || !splice_paragraphs(view, line, 1, added + 1)) {
+    if (added) {
+      line_index_join(&view->_lines, line, added);
+    }
+    paragraph(view, line)->version = view->_next_version++;
+  }
+}
+
+void
+cig_text_view_delete(cig_text_view *view, size_t position, size_t range)
+{
+  const size_t first = line_index_find(&view->_lines, position);
+  const size_t last = line_index_find(&view->_lines, position + range);
+
+  if (!range) {
+    return;
+  }
+
+  if (view->table) {
+    piece_table_char_delete(view->table, position, range);
+  } else {
+    gap_buffer_char_delete(&view->buffer, position, range);
+  }
+
+  if (!view->_lines.count) {
+    return;
+  }
+
+  if (first == last) {
+    paragraph(view, first)->version = view->_next_version++;
+  } else {
+    splice_paragraphs(view, first, last - first + 1, 1);
+  }
+}
+
+void
+cig_text_view_replace(cig_text_view *view, size_t position, size_t range, size_t count, const char text[])
+{
+  cig_text_view_delete(view, position, range);
+  cig_text_view_insert(view, position, count, text);
+}
+
+/*  ┌─────────┐
+    │ DISPLAY │
+    └─────────┘ */
+
+int64_t
+cig_text_view_content_height(const cig_text_view *view, int32_t line_height)
+{
+  return view->_measured_height + (int64_t)view->_unmeasured * line_height;
+}
+
+void
+cig_text_view_scroll_to_line(cig_text_view *view, size_t line)
+{
+  view->_scroll_to = line;
+}
+
+M_OPTIONAL(cig_frame*)
+cig_draw_text_view(cig_text_view *view, cig_r rect)
+{
+  if (!cig_push_frame(rect)) {
+    return NULL;
+  }
+
+  const cig_frame *frame = cig_current();
+  const bool scrolls = cig_enable_scroll(NULL);
+  const int32_t width = frame->rect.w - frame->insets.left - frame->insets.right;
+  const int32_t height = frame->rect.h - frame->insets.top - frame->insets.bottom;
+  const int32_t line_height = cig_font_info(view->font).height;
+  const size_t count = view->_lines.count;
+  cig_text_paragraph *p;
+  size_t i, offset;
+
+  /*  Unmeasured paragraphs are estimated with the font's height */
+  if (line_height != view->_line_height) {
+    view->_line_height = line_height;
+
+    for (i = 0; i < count; ++i) {
+      if (paragraph(view, i)->height < 0) {
+        fenwick_tree_set(&view->_heights, i, line_height);
+      }
+    }
+  }
+
+  if (scrolls && view->_scroll_to != NO_LINE) {
+    cig_set_offset(cig_v_make(0, fenwick_tree_prefix(&view->_heights, M_MIN(view->_scroll_to, count - 1))));
+  }
+  view->_scroll_to = NO_LINE;
+
+  int64_t top = scrolls ? cig_offset().y : 0;
+
+  /*  Paragraphs are culled here, they can start well above the viewport */
+  cig_disable_culling();
+
+  /*  First paragraph that ends below the top of the viewport */
+  i = M_MIN(fenwick_tree_find(&view->_heights, top), count - 1);
+  offset = fenwick_tree_prefix(&view->_lines, i);
+  int64_t y = fenwick_tree_prefix(&view->_heights, i);
+
+  for (; i < count && y < top + height; ++i) {
+    p = paragraph(view, i);
+
+    /*  Label gets the text without the newline */
+    const size_t bytes = fenwick_tree_get(&view->_lines, i);
+    const size_t length = bytes - (i + 1 < count ? 1 : 0);
+
+    if (length + 1 > view->_scratch_capacity) {
+      const size_t capacity = M_MAX(length + 1, view->_scratch_capacity * 2);
+      char *scratch = (char*)cig_allocator_resize(allocator_of(view), view->_scratch, view->_scratch_capacity, capacity);
+
+      /*  Paragraphs from here on are left out until there is memory for them */
+      if (!scratch) {
+        break;
+      }
+      view->_scratch = scratch;
+      view->_scratch_capacity = capacity;
+    }
+    /*  Labels take NUL terminated text, so even the piece table's runs are
+        copied out */
+    if (view->table) {
+      piece_table_char_read(view->table, offset, length, view->_scratch);
+    } else {
+      gap_buffer_char_read(view->buffer, offset, length, view->_scratch);
+    }
+    view->_scratch[length] = '\0';
+
+    /*  Frame is one line tall so its label's layout doesn't depend on the
+        paragraph's height. The label draws past it */
+    cig_set_next_id(CIG_TINYHASH(frame->id, p->version));
+
+    if (cig_push_frame(cig_r_make(0, y, width, line_height))) {
+      const cig_label *label = cig_draw_label_versioned((cig_text_properties) {
+        .font = view->font,
+        .color = view->color,
+        .alignment = { CIG_TEXT_ALIGN_LEFT, CIG_TEXT_ALIGN_TOP },
+        .flags = CIG_TEXT_PLAIN
+      }, p->version, view->_scratch);
+      const int32_t measured = M_MAX(label->bounds.h, line_height);
+      cig_pop_frame();
+
+      if (measured != p->height) {
+        const int32_t delta = measured - height_of(view, p);
+
+        account(view, p, -1);
+        p->height = measured;
+        account(view, p, 1);
+        fenwick_tree_set(&view->_heights, i, measured);
+
+        /*  Keeps the text in view still when a paragraph starting above it
+            turns out taller or shorter than estimated */
+        if (scrolls && y < top && delta) {
+          cig_change_offset(cig_v_make(0, delta));
+          top += delta;
+        }
+      }
+    }
+
+    y += height_of(view, p);
+    offset += bytes;
+  }
+
+  /*  Extends the scrollable content to the end of the text */
+  if (cig_push_frame(cig_r_make(0, fenwick_tree_prefix(&view->_heights, count) - 1, 1, 1))) {
+    cig_pop_frame();
+  }
+
+  return cig_pop_frame();
+}
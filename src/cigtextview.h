@@ -0,0 +1,88 @@
+#ifndef CIG_TEXT_VIEW_INCLUDED
+#define CIG_TEXT_VIEW_INCLUDED
+
+#include "cigtext.h"
+#include "types/gap_buffer.h"
+#include "types/piece_table.h"
+
+/*  ╔══════════════════════════════════════════════╗
+    ║ CIG TEXT VIEW                                ║
+    ║                                              ║
+    ║ Scrollable view of a large text in a gap     ║
+    ║ buffer or a piece table.                     ║
+    ║ Text is split into paragraphs at newlines,   ║
+    ║ and only the ones in the viewport are laid   ║
+    ║ out and drawn. An edit re-wraps only the     ║
+    ║ paragraphs it touches                        ║
+    ╚══════════════════════════════════════════════╝ */
+
+typedef struct {
+  int32_t height;               /* Height when last drawn, -1 if never drawn */
+  unsigned int version;         /* Changes with the text, identifies the paragraph's label */
+} cig_text_paragraph;
+
+typedef struct {
+  gap_buffer_char *buffer;      /* Edit through the view, buffer may be reallocated */
+  piece_table_char *table;      /* Text is in one or the other, the other is NULL */
+  cig_font_ref font;
+  cig_text_color_ref color;
+
+  /*_PRIVATE_*/
+  fenwick_tree _lines;          /* Paragraph lengths in bytes, the buffer's line index */
+  fenwick_tree _heights;        /* Paragraph heights, unmeasured ones as one line, with the paragraphs as items */
+  int64_t _measured_height;     /* Sum of heights of paragraphs that have been drawn */
+  size_t _unmeasured;           /* Paragraphs counted as one line */
+  unsigned int _next_version;
+  int32_t _line_height;         /* Font height in the last tick, estimate for unmeasured paragraphs */
+  size_t _scroll_to;            /* Line to scroll to in the next tick, or SIZE_MAX */
+  char *_scratch;               /* Paragraph text handed to the label */
+  size_t _scratch_capacity;
+} cig_text_view;
+
+/*  Indexes the paragraphs of `buffer`, attaching a line index to it that
+    edits keep up to date. This is the only time the whole text is scanned.
+    The view must stay at the same address while the buffer refers to it.
+    Its memory comes from the buffer's allocator, lines there's no memory
+    for stay part of the paragraph before them */
+void cig_text_view_init(cig_text_view*, gap_buffer_char *buffer);
+
+/*  Same as `cig_text_view_init` for a piece table, whose text is read from
+    its pieces directly */
+void cig_text_view_init_piece_table(cig_text_view*, piece_table_char *table);
+
+/*  Frees the index and detaches it from the text, the text is left to the
+    caller */
+void cig_text_view_free(cig_text_view*);
+
+/*  @return Number of paragraphs (lines) */
+size_t cig_text_view_paragraph_count(const cig_text_view*);
+
+/*  ┌─────────┐
+    │ EDITING │
+    └─────────┘ */
+
+void cig_text_view_insert(cig_text_view*, size_t position, size_t count, const char text[]);
+
+void cig_text_view_delete(cig_text_view*, size_t position, size_t range);
+
+void cig_text_view_replace(cig_text_view*, size_t position, size_t range, size_t count, const char text[]);
+
+/*  ┌─────────┐
+    │ DISPLAY │
+    └─────────┘ */
+
+/*  Pushes a scrolling frame and draws the paragraphs that are visible in it.
+    Paragraphs that haven't been drawn yet are counted as one line tall, so
+    the scrollable height settles as the text is scrolled through.
+
+    @return Frame of the view, already popped, or NULL if it wasn't visible */
+M_OPTIONAL(cig_frame*) cig_draw_text_view(cig_text_view*, cig_r rect);
+
+/*  Scrolls `line` to the top of the view in the next tick */
+void cig_text_view_scroll_to_line(cig_text_view*, size_t line);
+
+/*  @return Total height of the text, with paragraphs that haven't been drawn
+    counted as `line_height` */
+int64_t cig_text_view_content_height(const cig_text_view*, int32_t line_height);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef CIG_TYPE_ALLOCATOR_T_INCLUDED
+#define CIG_TYPE_ALLOCATOR_T_INCLUDED
+
+#include <common/macros.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*  Allocation callbacks. `realloc` and `free` are optional, without them
+    memory is not resized or released, as with an arena. `tracked_bytes`
+    counts everything allocated through it that's still alive */
+typedef struct {
+  void *(*alloc)  (void *ud, size_t size, size_t align);
+  void *(*realloc)(void *ud, void *ptr, size_t old_size, size_t new_size);
+  void  (*free)   (void *ud, void *ptr);
+  void *ud;
+  size_t tracked_bytes;
+} cig_allocator;
+
+/* Resizes `ptr` from `old_size` to `new_size` bytes, or allocates it if it's
+   NULL. NULL `allocator` is the C library.
+   @return The memory, or NULL if there was none, leaving `ptr` as it was */
+M_INLINED void*
+cig_allocator_resize(cig_allocator *allocator, void *ptr, size_t old_size, size_t new_size)
+{
+  void *result;
+
+  if (!allocator) {
+    return realloc(ptr, new_size);
+  }
+
+  if (ptr && allocator->realloc) {
+    result = allocator->realloc(allocator->ud, ptr, old_size, new_size);
+  } else if ((result = allocator->alloc(allocator->ud, new_size, sizeof(void*))) && ptr) {
+    memcpy(result, ptr, M_MIN(old_size, new_size));
+    if (allocator->free) {
+      allocator->free(allocator->ud, ptr);
+    }
+  }
+
+  if (result) {
+    allocator->tracked_bytes += new_size - old_size;
+  }
+
+  return result;
+}
+
+M_INLINED void
+cig_allocator_release(cig_allocator *allocator, void *ptr, size_t size)
+{
+  if (!ptr) {
+    return;
+  }
+
+  if (!allocator) {
+    free(ptr);
+    return;
+  }
+
+  allocator->tracked_bytes -= size;
+  if (allocator->free) {
+    allocator->free(allocator->ud, ptr);
+  }
+}
+
+#endif
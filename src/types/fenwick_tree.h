@@ -0,0 +1,556 @@
+#ifndef CIG_TYPE_FENWICK_TREE_T_INCLUDED
+#define CIG_TYPE_FENWICK_TREE_T_INCLUDED
+
+#include <common/macros.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "allocator.h"
+
+#define FENWICK_TREE_BLOCK 256
+
+/*  Sequence of non-negative values with O(log n) prefix sums and lookup of the
+    element a running total falls in. Values are kept in blocks of at most
+    `FENWICK_TREE_BLOCK`, each with a tree of its own, under two trees of the
+    blocks' sums and counts. Inserting or removing values only shifts the
+    block they're in, O(block + log n), and O(n / block) more when blocks are
+    split or joined.
+
+    Each value can carry an item of `item_size` bytes that moves along with
+    it. Set it, and the `allocator` memory comes from (NULL for the C
+    library), before the first value is added. An edit that runs out of
+    memory leaves the tree as it was and says so */
+typedef struct {
+  size_t count;
+  int64_t values[FENWICK_TREE_BLOCK];
+  int64_t tree[FENWICK_TREE_BLOCK + 1];  /* 1-based, `tree[i]` sums values (i - lowbit(i), i] */
+  unsigned char items[];
+} fenwick_tree_block;
+
+typedef struct {
+  size_t count;                 /* Values in all blocks */
+  size_t item_size;
+  cig_allocator *allocator;
+  size_t block_count;
+  size_t block_capacity;
+  fenwick_tree_block **blocks;  /* None of them empty */
+  int64_t *sums;                /* 1-based trees over the blocks' sums... */
+  int64_t *counts;              /* ...and their counts */
+} fenwick_tree;
+
+/*  ┌──────────┐
+    │ INTERNAL │
+    └──────────┘ */
+
+/* Turns `tree[1...n]` holding the values themselves into their tree */
+M_INLINED void
+fenwick_tree__build(int64_t *tree, size_t n)
+{
+  size_t i, j;
+
+  for (i = 1; i <= n; ++i) {
+    if ((j = i + (i & -i)) <= n) {
+      tree[j] += tree[i];
+    }
+  }
+}
+
+M_INLINED void
+fenwick_tree__add(int64_t *tree, size_t n, size_t index, int64_t delta)
+{
+  size_t i;
+
+  for (i = index + 1; i <= n; i += i & -i) {
+    tree[i] += delta;
+  }
+}
+
+M_INLINED int64_t
+fenwick_tree__prefix(const int64_t *tree, size_t count)
+{
+  int64_t sum = 0;
+
+  for (; count > 0; count -= count & -count) {
+    sum += tree[count];
+  }
+
+  return sum;
+}
+
+/* Largest `k` where the sum of the first `k` values is <= `*sum`, which is
+   left with the remainder */
+M_INLINED size_t
+fenwick_tree__find(const int64_t *tree, size_t n, int64_t *sum)
+{
+  size_t k = 0, step = 1;
+
+  while (step * 2 <= n) {
+    step *= 2;
+  }
+
+  for (; step && n; step /= 2) {
+    if (k + step <= n && tree[k + step] <= *sum) {
+      k += step;
+      *sum -= tree[k];
+    }
+  }
+
+  return k;
+}
+
+M_INLINED size_t
+fenwick_tree__block_size(const fenwick_tree *f)
+{
+  return sizeof(fenwick_tree_block) + FENWICK_TREE_BLOCK * f->item_size;
+}
+
+M_INLINED M_OPTIONAL(fenwick_tree_block*)
+fenwick_tree__new_block(fenwick_tree *f)
+{
+  fenwick_tree_block *b = (fenwick_tree_block*)cig_allocator_resize(f->allocator, NULL, 0, fenwick_tree__block_size(f));
+
+  if (b) {
+    b->count = 0;
+  }
+
+  return b;
+}
+
+M_INLINED void
+fenwick_tree__free_block(fenwick_tree *f, fenwick_tree_block *b)
+{
+  cig_allocator_release(f->allocator, b, fenwick_tree__block_size(f));
+}
+
+M_INLINED void
+fenwick_tree__release_arrays(fenwick_tree *f)
+{
+  cig_allocator_release(f->allocator, f->blocks, sizeof(fenwick_tree_block*) * f->block_capacity);
+  cig_allocator_release(f->allocator, f->sums, sizeof(int64_t) * (f->block_capacity + 1));
+  cig_allocator_release(f->allocator, f->counts, sizeof(int64_t) * (f->block_capacity + 1));
+}
+
+M_INLINED void
+fenwick_tree__build_block(fenwick_tree_block *b)
+{
+  memcpy(&b->tree[1], b->values, sizeof(int64_t) * b->count);
+  fenwick_tree__build(b->tree, b->count);
+}
+
+/* Moves `n` values and their items, the blocks can be the same */
+M_INLINED void
+fenwick_tree__move(const fenwick_tree *f, fenwick_tree_block *dst, size_t to, const fenwick_tree_block *src, size_t from, size_t n)
+{
+  memmove(&dst->values[to], &src->values[from], sizeof(int64_t) * n);
+  memmove(&dst->items[to * f->item_size], &src->items[from * f->item_size], f->item_size * n);
+}
+
+M_INLINED void
+fenwick_tree__zero(const fenwick_tree *f, fenwick_tree_block *b, size_t at, size_t n)
+{
+  memset(&b->values[at], 0, sizeof(int64_t) * n);
+  memset(&b->items[at * f->item_size], 0, f->item_size * n);
+}
+
+/* Builds the trees over the blocks */
+M_INLINED void
+fenwick_tree__index(fenwick_tree *f)
+{
+  size_t k;
+
+  for (k = 0; k < f->block_count; ++k) {
+    f->sums[k+1] = fenwick_tree__prefix(f->blocks[k]->tree, f->blocks[k]->count);
+    f->counts[k+1] = f->blocks[k]->count;
+  }
+
+  fenwick_tree__build(f->sums, f->block_count);
+  fenwick_tree__build(f->counts, f->block_count);
+}
+
+/* Grows the arrays of blocks to hold `n` of them, all three or none */
+M_INLINED bool
+fenwick_tree__reserve(fenwick_tree *f, size_t n)
+{
+  fenwick_tree_block **blocks;
+  int64_t *sums, *counts;
+  size_t capacity = f->block_capacity ? f->block_capacity : 16;
+
+  if (n <= f->block_capacity) {
+    return true;
+  }
+
+  while (capacity < n) {
+    capacity *= 2;
+  }
+
+  blocks = (fenwick_tree_block**)cig_allocator_resize(f->allocator, NULL, 0, sizeof(fenwick_tree_block*) * capacity);
+  sums = (int64_t*)cig_allocator_resize(f->allocator, NULL, 0, sizeof(int64_t) * (capacity + 1));
+  counts = (int64_t*)cig_allocator_resize(f->allocator, NULL, 0, sizeof(int64_t) * (capacity + 1));
+
+  if (!blocks || !sums || !counts) {
+    cig_allocator_release(f->allocator, blocks, sizeof(fenwick_tree_block*) * capacity);
+    cig_allocator_release(f->allocator, sums, sizeof(int64_t) * (capacity + 1));
+    cig_allocator_release(f->allocator, counts, sizeof(int64_t) * (capacity + 1));
+    return false;
+  }
+
+  if (f->block_capacity) {
+    memcpy(blocks, f->blocks, sizeof(fenwick_tree_block*) * f->block_count);
+    memcpy(sums, f->sums, sizeof(int64_t) * (f->block_count + 1));
+    memcpy(counts, f->counts, sizeof(int64_t) * (f->block_count + 1));
+  }
+
+  fenwick_tree__release_arrays(f);
+  f->blocks = blocks;
+  f->sums = sums;
+  f->counts = counts;
+  f->block_capacity = capacity;
+
+  return true;
+}
+
+/* Shifts blocks to leave `n` free slots at `index`, there must be room */
+M_INLINED void
+fenwick_tree__open(fenwick_tree *f, size_t index, size_t n)
+{
+  memmove(&f->blocks[index + n], &f->blocks[index], sizeof(fenwick_tree_block*) * (f->block_count - index));
+  f->block_count += n;
+}
+
+M_INLINED void
+fenwick_tree__close(fenwick_tree *f, size_t index, size_t n)
+{
+  memmove(&f->blocks[index], &f->blocks[index + n], sizeof(fenwick_tree_block*) * (f->block_count - index - n));
+  f->block_count -= n;
+}
+
+/* @return Block of the value at `index`, or `block_count` past the end */
+M_INLINED size_t
+fenwick_tree__locate(const fenwick_tree *f, size_t index, size_t *offset)
+{
+  int64_t rest = index;
+  const size_t k = fenwick_tree__find(f->counts, f->block_count, &rest);
+  *offset = rest;
+  return k;
+}
+
+/* Fills the empty block `dst` with `size` values from `from` onwards of `src`
+   as if `n` zeros were inserted into it at `offset` */
+M_INLINED void
+fenwick_tree__spread(const fenwick_tree *f, fenwick_tree_block *dst, const fenwick_tree_block *src, size_t offset, size_t n, size_t from, size_t size)
+{
+  const size_t end = from + size;
+  size_t part;
+
+  if (from < offset) {
+    part = M_MIN(end, offset) - from;
+    fenwick_tree__move(f, dst, dst->count, src, from, part);
+    dst->count += part;
+    from += part;
+  }
+  if (from < end && from < offset + n) {
+    part = M_MIN(end, offset + n) - from;
+    fenwick_tree__zero(f, dst, dst->count, part);
+    dst->count += part;
+    from += part;
+  }
+  if (from < end) {
+    part = end - from;
+    fenwick_tree__move(f, dst, dst->count, src, from - n, part);
+    dst->count += part;
+  }
+
+  fenwick_tree__build_block(dst);
+}
+
+/* Joins block `k` and the one after it if they fill at most half a block, so
+   the joined one has room for as many values before it's split again */
+M_INLINED bool
+fenwick_tree__join(fenwick_tree *f, size_t k)
+{
+  fenwick_tree_block *a, *b;
+
+  if (k + 1 >= f->block_count || f->blocks[k]->count + f->blocks[k+1]->count > FENWICK_TREE_BLOCK / 2) {
+    return false;
+  }
+
+  a = f->blocks[k];
+  b = f->blocks[k+1];
+  fenwick_tree__move(f, a, a->count, b, 0, b->count);
+  a->count += b->count;
+  fenwick_tree__build_block(a);
+  fenwick_tree__free_block(f, b);
+  fenwick_tree__close(f, k + 1, 1);
+
+  return true;
+}
+
+/*  ┌────────┐
+    │ MEMORY │
+    └────────┘ */
+
+M_INLINED void
+fenwick_tree_init(fenwick_tree *f)
+{
+  *f = (fenwick_tree) { 0 };
+}
+
+/* Removes all values, keeping `item_size` and `allocator` */
+M_INLINED void
+fenwick_tree_clear(fenwick_tree *f)
+{
+  size_t k;
+
+  for (k = 0; k < f->block_count; ++k) {
+    fenwick_tree__free_block(f, f->blocks[k]);
+  }
+
+  f->block_count = f->count = 0;
+}
+
+M_INLINED void
+fenwick_tree_free(fenwick_tree *f)
+{
+  fenwick_tree_clear(f);
+  fenwick_tree__release_arrays(f);
+  *f = (fenwick_tree) { 0 };
+}
+
+/*  ┌──────────┐
+    │ BUILDING │
+    └──────────┘ */
+
+/* Appends a value without updating the sums, call `fenwick_tree_rebuild`
+   after the last one. @return Its item, zeroed, or NULL if there was no
+   memory for it */
+M_INLINED M_OPTIONAL(void*)
+fenwick_tree_push(fenwick_tree *f, int64_t value)
+{
+  fenwick_tree_block *b;
+
+  if (!f->block_count || f->blocks[f->block_count-1]->count == FENWICK_TREE_BLOCK) {
+    if (!fenwick_tree__reserve(f, f->block_count + 1) || !(b = fenwick_tree__new_block(f))) {
+      return NULL;
+    }
+    fenwick_tree__open(f, f->block_count, 1);
+    f->blocks[f->block_count-1] = b;
+  }
+
+  b = f->blocks[f->block_count-1];
+  fenwick_tree__zero(f, b, b->count, 1);
+  b->values[b->count] = value;
+  f->count++;
+
+  return &b->items[b->count++ * f->item_size];
+}
+
+/* Builds all the trees in linear time */
+M_INLINED void
+fenwick_tree_rebuild(fenwick_tree *f)
+{
+  size_t k;
+
+  for (k = 0; k < f->block_count; ++k) {
+    fenwick_tree__build_block(f->blocks[k]);
+  }
+
+  fenwick_tree__index(f);
+}
+
+/*  ┌────────┐
+    │ VALUES │
+    └────────┘ */
+
+M_INLINED int64_t
+fenwick_tree_get(const fenwick_tree *f, size_t index)
+{
+  size_t offset;
+  const size_t k = fenwick_tree__locate(f, index, &offset);
+  return f->blocks[k]->values[offset];
+}
+
+/* Item that goes with the value at `index` */
+M_INLINED void*
+fenwick_tree_item(const fenwick_tree *f, size_t index)
+{
+  size_t offset;
+  const size_t k = fenwick_tree__locate(f, index, &offset);
+  return &f->blocks[k]->items[offset * f->item_size];
+}
+
+M_INLINED void
+fenwick_tree_add(fenwick_tree *f, size_t index, int64_t delta)
+{
+  size_t offset;
+  const size_t k = fenwick_tree__locate(f, index, &offset);
+  fenwick_tree_block *b = f->blocks[k];
+
+  b->values[offset] += delta;
+  fenwick_tree__add(b->tree, b->count, offset, delta);
+  fenwick_tree__add(f->sums, f->block_count, k, delta);
+}
+
+M_INLINED void
+fenwick_tree_set(fenwick_tree *f, size_t index, int64_t value)
+{
+  fenwick_tree_add(f, index, value - fenwick_tree_get(f, index));
+}
+
+/* Sum of the first `count` values */
+M_INLINED int64_t
+fenwick_tree_prefix(const fenwick_tree *f, size_t count)
+{
+  size_t offset;
+  const size_t k = fenwick_tree__locate(f, count, &offset);
+  int64_t sum = fenwick_tree__prefix(f->sums, k);
+
+  if (k < f->block_count) {
+    sum += fenwick_tree__prefix(f->blocks[k]->tree, offset);
+  }
+
+  return sum;
+}
+
+/* @return Largest `k` where the sum of the first `k` values is <= `sum`, which
+   is the index of the element `sum` falls in, or `count` past the end */
+M_INLINED size_t
+fenwick_tree_find(const fenwick_tree *f, int64_t sum)
+{
+  const size_t k = fenwick_tree__find(f->sums, f->block_count, &sum);
+
+  if (k == f->block_count) {
+    return f->count;
+  }
+
+  return (size_t)fenwick_tree__prefix(f->counts, k) + fenwick_tree__find(f->blocks[k]->tree, f->blocks[k]->count, &sum);
+}
+
+/*  ┌─────────┐
+    │ EDITING │
+    └─────────┘ */
+
+/* Inserts `n` zero values at `index`. A block that would overflow is split
+   into as few blocks as fit its values, evenly filled.
+   @return False if there was no memory for them */
+M_INLINED bool
+fenwick_tree_insert(fenwick_tree *f, size_t index, size_t n)
+{
+  fenwick_tree_block *b, **spare;
+  size_t k, offset, total, pieces, from, size, i;
+
+  if (!n) {
+    return true;
+  }
+
+  if (!f->block_count) {
+    if (!fenwick_tree__reserve(f, 1) || !(b = fenwick_tree__new_block(f))) {
+      return false;
+    }
+    fenwick_tree__open(f, 0, 1);
+    f->blocks[0] = b;
+    fenwick_tree__index(f);
+  }
+
+  /*  Values appended at the end go to the last block */
+  if ((k = fenwick_tree__locate(f, index, &offset)) == f->block_count) {
+    offset = f->blocks[--k]->count;
+  }
+
+  b = f->blocks[k];
+
+  if (b->count + n <= FENWICK_TREE_BLOCK) {
+    fenwick_tree__move(f, b, offset + n, b, offset, b->count - offset);
+    fenwick_tree__zero(f, b, offset, n);
+    b->count += n;
+    f->count += n;
+    fenwick_tree__build_block(b);
+    fenwick_tree__add(f->counts, f->block_count, k, n);
+    return true;
+  }
+
+  total = b->count + n;
+  pieces = (total + FENWICK_TREE_BLOCK - 1) / FENWICK_TREE_BLOCK;
+
+  /*  New blocks are all allocated before anything changes, into the slots
+      past the ones the blocks after `k` are shifted to */
+  if (!fenwick_tree__reserve(f, f->block_count + 2 * pieces - 1)) {
+    return false;
+  }
+
+  spare = &f->blocks[f->block_count + pieces - 1];
+  for (i = 0; i < pieces; ++i) {
+    if (!(spare[i] = fenwick_tree__new_block(f))) {
+      while (i--) {
+        fenwick_tree__free_block(f, spare[i]);
+      }
+      return false;
+    }
+  }
+
+  fenwick_tree__open(f, k + 1, pieces - 1);
+  f->count += n;
+
+  for (i = 0, from = 0; i < pieces; ++i, from += size) {
+    size = total / pieces + (i < total % pieces);
+    f->blocks[k + i] = spare[i];
+    fenwick_tree__spread(f, f->blocks[k + i], b, offset, n, from, size);
+  }
+
+  fenwick_tree__free_block(f, b);
+  fenwick_tree__index(f);
+
+  return true;
+}
+
+/* Removes `n` values from `index`. Emptied blocks are dropped, and the ones
+   around the removed values joined if they're left half empty */
+M_INLINED void
+fenwick_tree_remove(fenwick_tree *f, size_t index, size_t n)
+{
+  fenwick_tree_block *b;
+  size_t offset, part, i, j;
+  const size_t first = fenwick_tree__locate(f, index, &offset);
+  size_t k = first;
+  bool changed = false;
+
+  f->count -= n;
+
+  for (; n; n -= part, offset = 0, ++k) {
+    b = f->blocks[k];
+    part = M_MIN(n, b->count - offset);
+
+    if (part == b->count) {
+      fenwick_tree__free_block(f, b);
+      f->blocks[k] = NULL;
+      changed = true;
+    } else {
+      fenwick_tree__add(f->sums, f->block_count, k, fenwick_tree__prefix(b->tree, offset) - fenwick_tree__prefix(b->tree, offset + part));
+      fenwick_tree__add(f->counts, f->block_count, k, -(int64_t)part);
+      fenwick_tree__move(f, b, offset, b, offset + part, b->count - offset - part);
+      b->count -= part;
+      fenwick_tree__build_block(b);
+    }
+  }
+
+  if (changed) {
+    for (i = j = first; i < k; ++i) {
+      if (f->blocks[i]) {
+        f->blocks[j++] = f->blocks[i];
+      }
+    }
+    fenwick_tree__close(f, j, k - j);
+  }
+
+  changed |= fenwick_tree__join(f, first);
+  if (first) {
+    changed |= fenwick_tree__join(f, first - 1);
+  }
+
+  if (changed) {
+    fenwick_tree__index(f);
+  }
+}
+
+#endif
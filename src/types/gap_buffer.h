@@ -2,13 +2,19 @@
 #define CIG_TYPE_GAP_BUFFER_T_INCLUDED
 
 #include <common/macros.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
+#include "allocator.h"
+#include "line_index.h"
 
 #define GAPHEAD 0
 #define GAPCURPOS -1
 #define GAPTAIL -2
 
+#define GAP_BUFFER_MIN_SIZE 16
+
 typedef struct {
   size_t size;
   // size_t element_size;
@@ -16,19 +22,108 @@ typedef struct {
     size_t start;
     size_t size;
   } gap;
+  cig_allocator *allocator;  /* NULL for the C library */
+  fenwick_tree *lines;       /* Line lengths, kept up to date by edits if set */
   char buffer[];
 } gap_buffer_char;
 
+/*  ┌────────┐
+    │ MEMORY │
+    └────────┘ */
+
+/* Memory comes from `allocator` and counts towards its `tracked_bytes`. Pass
+   `&context->allocator` to share the context's, or NULL for malloc/free */
 M_INLINED void
-gap_buffer_char_new(gap_buffer_char **ptr, size_t position, size_t init_size)
+gap_buffer_char_new(gap_buffer_char **ptr, cig_allocator *allocator, size_t position, size_t init_size)
 {
-  *ptr = (gap_buffer_char*)malloc(sizeof(gap_buffer_char) + sizeof(char) * init_size);
+  const size_t bytes = sizeof(gap_buffer_char) + sizeof(char) * init_size;
+
+  if (allocator) {
+    *ptr = (gap_buffer_char*)allocator->alloc(allocator->ud, bytes, sizeof(void*));
+    allocator->tracked_bytes += bytes;
+  } else {
+    *ptr = (gap_buffer_char*)malloc(bytes);
+  }
+
   // (*ptr)->element_size = sizeof(char);
   (*ptr)->size = init_size;
   (*ptr)->gap.start = position;
   (*ptr)->gap.size = init_size;
+  (*ptr)->allocator = allocator;
+  (*ptr)->lines = NULL;
+}
+
+/* Resizes the buffer to `new_size`, keeping the text after the gap at the end */
+M_INLINED void
+gap_buffer_char_resize(gap_buffer_char **ptr, size_t new_size)
+{
+  gap_buffer_char *buf = *ptr;
+  cig_allocator *allocator = buf->allocator;
+  const size_t old_bytes = sizeof(gap_buffer_char) + sizeof(char) * buf->size;
+  const size_t new_bytes = sizeof(gap_buffer_char) + sizeof(char) * new_size;
+  const size_t post_gap = buf->size - (buf->gap.start + buf->gap.size);
+
+  if (!allocator) {
+    buf = (gap_buffer_char*)realloc(buf, new_bytes);
+  } else {
+    if (allocator->realloc) {
+      buf = (gap_buffer_char*)allocator->realloc(allocator->ud, buf, old_bytes, new_bytes);
+    } else {
+      buf = (gap_buffer_char*)allocator->alloc(allocator->ud, new_bytes, sizeof(void*));
+      memcpy(buf, *ptr, old_bytes);
+      if (allocator->free) {
+        allocator->free(allocator->ud, *ptr);
+      }
+    }
+    allocator->tracked_bytes += new_bytes - old_bytes;
+  }
+
+  memmove(
+    buf->buffer + new_size - post_gap,
+    buf->buffer + buf->gap.start + buf->gap.size,
+    post_gap
+  );
+
+  buf->gap.size += new_size - buf->size;
+  buf->size = new_size;
+  *ptr = buf;
+}
+
+/* Makes room for `count` more characters, growing the buffer exactly as much
+   as needed. Use before bulk loads so they don't grow it step by step */
+M_INLINED void
+gap_buffer_char_reserve(gap_buffer_char **ptr, size_t count)
+{
+  if (count > (*ptr)->gap.size) {
+    gap_buffer_char_resize(ptr, (*ptr)->size + (count - (*ptr)->gap.size));
+  }
+}
+
+M_INLINED void
+gap_buffer_char_free(gap_buffer_char **ptr)
+{
+  cig_allocator *allocator;
+
+  if (!*ptr) {
+    return;
+  }
+
+  if ((allocator = (*ptr)->allocator)) {
+    allocator->tracked_bytes -= sizeof(gap_buffer_char) + sizeof(char) * (*ptr)->size;
+    if (allocator->free) {
+      allocator->free(allocator->ud, *ptr);
+    }
+  } else {
+    free(*ptr);
+  }
+
+  *ptr = NULL;
 }
 
+/*  ┌─────┐
+    │ GAP │
+    └─────┘ */
+
 M_INLINED void
 gap_buffer_char_place_gap(gap_buffer_char **ptr, ptrdiff_t position)
 {
@@ -61,28 +156,78 @@ gap_buffer_char_place_gap(gap_buffer_char **ptr, ptrdiff_t position)
   (*ptr)->gap.start = position;
 }
 
+/* Doubles the buffer until the gap fits `size` characters */
 M_INLINED void
 gap_buffer_char_extend_gap(gap_buffer_char **ptr, size_t size)
 {
+  size_t new_size = (*ptr)->size > GAP_BUFFER_MIN_SIZE ? (*ptr)->size : GAP_BUFFER_MIN_SIZE;
+
   if (size <= (*ptr)->gap.size) {
     return;
   }
 
-  const size_t new_size = (*ptr)->size * 2;
-  const size_t post_gap = (*ptr)->size - ((*ptr)->gap.start + (*ptr)->gap.size);
+  while ((*ptr)->gap.size + (new_size - (*ptr)->size) < size) {
+    new_size *= 2;
+  }
 
-  *ptr = (gap_buffer_char*)realloc(*ptr, sizeof(gap_buffer_char) + sizeof(char) * new_size);
+  gap_buffer_char_resize(ptr, new_size);
+}
 
-  memmove(
-    (*ptr)->buffer + (*ptr)->gap.start + (*ptr)->gap.size + (new_size - (*ptr)->size),
-    (*ptr)->buffer + (*ptr)->gap.start + (*ptr)->gap.size,
-    post_gap
-  );
+/*  ┌────────────┐
+    │ LINE INDEX │
+    └────────────┘ */
+
+/* Indexes the lengths of lines into `lines`, which edits then keep up to
+   date. This is the only time the whole text is scanned.
+   @return False if there was no memory for even one line, `lines` isn't
+   attached then */
+M_INLINED bool
+gap_buffer_char_index_lines(gap_buffer_char *buf, fenwick_tree *lines)
+{
+  size_t pending = 0;
+
+  fenwick_tree_clear(lines);
+  line_index_scan(lines, buf->buffer, buf->gap.start, &pending);
+  line_index_scan(lines, buf->buffer + buf->gap.start + buf->gap.size, buf->size - buf->gap.start - buf->gap.size, &pending);
+  line_index_finish(lines, pending);
+
+  if (!lines->count) {
+    return false;
+  }
+
+  buf->lines = lines;
+  return true;
+}
+
+/* Line containing `position`, see `line_index.h` */
+M_INLINED size_t
+gap_buffer_char_line_at(const gap_buffer_char *buf, size_t position)
+{
+  return line_index_find(buf->lines, position);
+}
+
+M_INLINED size_t
+gap_buffer_char_line_start(const gap_buffer_char *buf, size_t line)
+{
+  return fenwick_tree_prefix(buf->lines, line);
+}
 
-  (*ptr)->gap.size += (new_size - (*ptr)->size);
-  (*ptr)->size = new_size;
+M_INLINED size_t
+gap_buffer_char_line_length(const gap_buffer_char *buf, size_t line)
+{
+  return fenwick_tree_get(buf->lines, line);
 }
 
+M_INLINED size_t
+gap_buffer_char_line_count(const gap_buffer_char *buf)
+{
+  return buf->lines->count;
+}
+
+/*  ┌─────────┐
+    │ EDITING │
+    └─────────┘ */
+
 M_INLINED void
 gap_buffer_char_insert(gap_buffer_char **ptr, ptrdiff_t position, size_t count, const char buffer[])
 {
@@ -91,6 +236,10 @@ gap_buffer_char_insert(gap_buffer_char **ptr, ptrdiff_t position, size_t count,
 
   memcpy((*ptr)->buffer + (*ptr)->gap.start, buffer, count);
 
+  if ((*ptr)->lines && count) {
+    line_index_inserted((*ptr)->lines, (*ptr)->gap.start, count, buffer);
+  }
+
   (*ptr)->gap.start += count;
   (*ptr)->gap.size -= count;
 }
@@ -100,6 +249,10 @@ gap_buffer_char_delete(gap_buffer_char **ptr, ptrdiff_t position, size_t range)
 {
   gap_buffer_char_place_gap(ptr, position);
   (*ptr)->gap.size += range;
+
+  if ((*ptr)->lines && range) {
+    line_index_deleted((*ptr)->lines, (*ptr)->gap.start, range);
+  }
 }
 
 M_INLINED void
@@ -109,12 +262,25 @@ gap_buffer_char_replace(gap_buffer_char **ptr, ptrdiff_t position, size_t range,
   gap_buffer_char_insert(ptr, position, count, buffer);
 }
 
+/* Number of characters stored, not counting the gap */
+M_INLINED size_t
+gap_buffer_char_length(const gap_buffer_char *buf)
+{
+  return buf->size - buf->gap.size;
+}
+
+/* Copies `count` characters from `position` into `out`, skipping the gap */
 M_INLINED void
-gap_buffer_char_free(gap_buffer_char **ptr)
+gap_buffer_char_read(const gap_buffer_char *buf, size_t position, size_t count, char out[])
 {
-  if (*ptr) {
-    free(*ptr);
-    *ptr = NULL;
+  const size_t before_gap = position < buf->gap.start
+    ? (buf->gap.start - position < count ? buf->gap.start - position : count)
+    : 0;
+
+  memcpy(out, buf->buffer + position, before_gap);
+
+  if (count > before_gap) {
+    memcpy(out + before_gap, buf->buffer + position + before_gap + buf->gap.size, count - before_gap);
   }
 }
 
@@ -0,0 +1,110 @@
+#ifndef CIG_TYPE_LINE_INDEX_T_INCLUDED
+#define CIG_TYPE_LINE_INDEX_T_INCLUDED
+
+#include <common/macros.h>
+#include <stddef.h>
+#include <string.h>
+#include "fenwick_tree.h"
+
+/*  Line lengths of a text in a `fenwick_tree`, shared by the text storage
+    types. Lengths include the newline that ends the line, the last line has
+    none and can be empty, so there is always at least one line. Lines that
+    there's no memory for in the tree stay part of the line before them */
+
+/* Adds the lines of `str` to the index. `pending` carries the length of the
+   unfinished line from one call to the next, start it at 0 */
+M_INLINED void
+line_index_scan(fenwick_tree *lines, const char *str, size_t length, size_t *pending)
+{
+  const char *end = str + length, *newline;
+
+  while ((newline = memchr(str, '\n', end - str))) {
+    if (fenwick_tree_push(lines, *pending + (newline - str) + 1)) {
+      *pending = 0;
+    } else {
+      *pending += (newline - str) + 1;
+    }
+    str = newline + 1;
+  }
+
+  *pending += end - str;
+}
+
+/* Adds the last line and builds the tree */
+M_INLINED void
+line_index_finish(fenwick_tree *lines, size_t pending)
+{
+  const bool pushed = fenwick_tree_push(lines, pending) != NULL;
+
+  fenwick_tree_rebuild(lines);
+  if (!pushed && lines->count) {
+    fenwick_tree_add(lines, lines->count - 1, pending);
+  }
+}
+
+/* Line containing `position` */
+M_INLINED size_t
+line_index_find(const fenwick_tree *lines, size_t position)
+{
+  const size_t line = fenwick_tree_find(lines, position);
+  return line < lines->count ? line : lines->count - 1;
+}
+
+M_INLINED void
+line_index_inserted(fenwick_tree *lines, size_t position, size_t count, const char text[])
+{
+  const size_t line = line_index_find(lines, position);
+  const char *end = text + count, *newline = memchr(text, '\n', count), *next;
+  size_t i, n = 0, head, tail;
+
+  if (!newline) {
+    fenwick_tree_add(lines, line, count);
+    return;
+  }
+
+  for (i = newline - text; i < count; ++i) {
+    n += text[i] == '\n';
+  }
+
+  head = position - fenwick_tree_prefix(lines, line);
+  tail = fenwick_tree_get(lines, line) - head;
+
+  if (!fenwick_tree_insert(lines, line + 1, n)) {
+    fenwick_tree_add(lines, line, count);
+    return;
+  }
+
+  /*  Text up to the first newline ends the split line, the rest starts the
+      line that follows */
+  fenwick_tree_set(lines, line, head + (newline - text) + 1);
+  for (i = 1, text = newline + 1; (next = memchr(text, '\n', end - text)); ++i, text = next + 1) {
+    fenwick_tree_set(lines, line + i, next - text + 1);
+  }
+  fenwick_tree_set(lines, line + i, (end - text) + tail);
+}
+
+/* Joins the `n` lines after `line` into it */
+M_INLINED void
+line_index_join(fenwick_tree *lines, size_t line, size_t n)
+{
+  fenwick_tree_set(lines, line, fenwick_tree_prefix(lines, line + n + 1) - fenwick_tree_prefix(lines, line));
+  fenwick_tree_remove(lines, line + 1, n);
+}
+
+M_INLINED void
+line_index_deleted(fenwick_tree *lines, size_t position, size_t range)
+{
+  const size_t first = line_index_find(lines, position);
+  const size_t last = line_index_find(lines, position + range);
+
+  if (first == last) {
+    fenwick_tree_add(lines, first, -(int64_t)range);
+    return;
+  }
+
+  /*  First and last line join, the ones in between are gone */
+  line_index_join(lines, first, last - first);
+  fenwick_tree_add(lines, first, -(int64_t)range);
+}
+
+#endif
@@ -0,0 +1,412 @@
+#ifndef CIG_TYPE_PIECE_TABLE_T_INCLUDED
+#define CIG_TYPE_PIECE_TABLE_T_INCLUDED
+
+#include <common/macros.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "allocator.h"
+#include "line_index.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PIECE_TABLE_MMAP
+#endif
+
+/*  Text as a sequence of pieces of two buffers: the original text, which is
+    never written to and can be a read-only mapping of a file, and an append
+    buffer with everything inserted since. Unlike a gap buffer, loading a
+    file doesn't copy it, which suits large texts that are mostly read */
+
+typedef enum {
+  PIECE_ORIGINAL,
+  PIECE_ADDED
+} piece_table_source;
+
+typedef struct {
+  piece_table_source source;
+  size_t start,
+         length;
+} piece_table_piece;
+
+typedef struct {
+  const char *original;
+  size_t original_length;
+  char *added;
+  size_t added_length,
+         added_capacity;
+  piece_table_piece *pieces;
+  size_t piece_count,
+         piece_capacity;
+  size_t length;
+  cig_allocator *allocator;  /* NULL for the C library */
+  fenwick_tree *lines;       /* Line lengths, kept up to date by edits if set */
+
+  /*_PRIVATE_*/
+  struct {
+    size_t piece,
+           start;            /* Text position of the piece */
+  } _cursor;                 /* Last piece looked up, edits are usually close to each other */
+  enum {
+    PIECE_TABLE_BORROWED,
+    PIECE_TABLE_MAPPED,
+    PIECE_TABLE_OWNED
+  } _original_memory;
+} piece_table_char;
+
+/*  Contiguous runs of text between two positions, see `piece_table_char_next` */
+typedef struct {
+  piece_table_char *table;
+  size_t piece,
+         offset,             /* Into the piece */
+         remaining;
+} piece_table_char_iterator;
+
+/*  ┌────────┐
+    │ MEMORY │
+    └────────┘ */
+
+/* Text starts out as `original`, which is borrowed and must outlive the table */
+M_INLINED void
+piece_table_char_init(piece_table_char *table, cig_allocator *allocator, const char *original, size_t length)
+{
+  *table = (piece_table_char) {
+    .original = original,
+    .original_length = length,
+    .length = length,
+    .allocator = allocator
+  };
+
+  if (length) {
+    table->piece_capacity = 16;
+    table->pieces = (piece_table_piece*)cig_allocator_resize(allocator, NULL, 0, sizeof(piece_table_piece) * 16);
+    table->pieces[table->piece_count++] = (piece_table_piece) { PIECE_ORIGINAL, 0, length };
+  }
+}
+
+/* Text starts out as the contents of the file at `path`. Where `mmap` is
+   available the file is mapped read-only rather than read in, so only the
+   pages that are looked at are loaded. The file must not change while it's
+   mapped.
+
+   @return False if the file can't be read */
+M_INLINED bool
+piece_table_char_open(piece_table_char *table, cig_allocator *allocator, const char *path)
+{
+#ifdef PIECE_TABLE_MMAP
+  struct stat info;
+  void *mapping = NULL;
+  const int fd = open(path, O_RDONLY);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  if (fstat(fd, &info) || (info.st_size && (mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)) {
+    close(fd);
+    return false;
+  }
+
+  close(fd);
+  piece_table_char_init(table, allocator, (const char*)mapping, info.st_size);
+  table->_original_memory = PIECE_TABLE_MAPPED;
+
+  return true;
+#else
+  FILE *file = fopen(path, "rb");
+  char *bytes;
+  long size;
+
+  if (!file) {
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  bytes = (char*)cig_allocator_resize(allocator, NULL, 0, size ? size : 1);
+
+  if (size < 0 || fread(bytes, 1, size, file) != (size_t)size) {
+    cig_allocator_release(allocator, bytes, size ? size : 1);
+    fclose(file);
+    return false;
+  }
+
+  fclose(file);
+  piece_table_char_init(table, allocator, bytes, size);
+  table->_original_memory = PIECE_TABLE_OWNED;
+
+  return true;
+#endif
+}
+
+M_INLINED void
+piece_table_char_free(piece_table_char *table)
+{
+#ifdef PIECE_TABLE_MMAP
+  if (table->_original_memory == PIECE_TABLE_MAPPED && table->original_length) {
+    munmap((void*)table->original, table->original_length);
+  }
+#endif
+  if (table->_original_memory == PIECE_TABLE_OWNED) {
+    cig_allocator_release(table->allocator, (void*)table->original, table->original_length ? table->original_length : 1);
+  }
+
+  cig_allocator_release(table->allocator, table->added, table->added_capacity);
+  cig_allocator_release(table->allocator, table->pieces, sizeof(piece_table_piece) * table->piece_capacity);
+  *table = (piece_table_char) { 0 };
+}
+
+/*  ┌────────┐
+    │ PIECES │
+    └────────┘ */
+
+M_INLINED const char*
+piece_table_char_piece_text(const piece_table_char *table, const piece_table_piece *piece)
+{
+  return (piece->source == PIECE_ORIGINAL ? table->original : table->added) + piece->start;
+}
+
+/* Moves the cursor to the piece containing `position`, or past the last
+   piece if `position` is the end of the text */
+M_INLINED void
+piece_table_char_seek(piece_table_char *table, size_t position)
+{
+  size_t i = table->_cursor.piece, start = table->_cursor.start;
+
+  while (i > 0 && position < start) {
+    i--;
+    start -= table->pieces[i].length;
+  }
+
+  while (i < table->piece_count && position >= start + table->pieces[i].length) {
+    start += table->pieces[i].length;
+    i++;
+  }
+
+  table->_cursor.piece = i;
+  table->_cursor.start = start;
+}
+
+M_INLINED void
+piece_table_char_insert_pieces(piece_table_char *table, size_t index, size_t count)
+{
+  if (table->piece_count + count > table->piece_capacity) {
+    size_t capacity = table->piece_capacity ? table->piece_capacity : 16;
+
+    while (capacity < table->piece_count + count) {
+      capacity *= 2;
+    }
+
+    table->pieces = (piece_table_piece*)cig_allocator_resize(
+      table->allocator,
+      table->pieces,
+      sizeof(piece_table_piece) * table->piece_capacity,
+      sizeof(piece_table_piece) * capacity
+    );
+    table->piece_capacity = capacity;
+  }
+
+  memmove(&table->pieces[index + count], &table->pieces[index], sizeof(piece_table_piece) * (table->piece_count - index));
+  table->piece_count += count;
+}
+
+/* @return Index of the piece that starts at `position`, splitting the piece
+   it falls in if needed */
+M_INLINED size_t
+piece_table_char_split(piece_table_char *table, size_t position)
+{
+  piece_table_char_seek(table, position);
+
+  const size_t i = table->_cursor.piece, offset = position - table->_cursor.start;
+
+  if (i == table->piece_count || offset == 0) {
+    return i;
+  }
+
+  piece_table_char_insert_pieces(table, i + 1, 1);
+  table->pieces[i + 1] = (piece_table_piece) {
+    table->pieces[i].source,
+    table->pieces[i].start + offset,
+    table->pieces[i].length - offset
+  };
+  table->pieces[i].length = offset;
+  table->_cursor.piece = i + 1;
+  table->_cursor.start = position;
+
+  return i + 1;
+}
+
+/*  ┌─────────┐
+    │ EDITING │
+    └─────────┘ */
+
+M_INLINED void
+piece_table_char_insert(piece_table_char *table, size_t position, size_t count, const char text[])
+{
+  piece_table_piece *previous;
+  size_t i;
+
+  if (!count) {
+    return;
+  }
+
+  if (table->lines) {
+    line_index_inserted(table->lines, position, count, text);
+  }
+
+  if (table->added_length + count > table->added_capacity) {
+    size_t capacity = table->added_capacity ? table->added_capacity : 256;
+
+    while (capacity < table->added_length + count) {
+      capacity *= 2;
+    }
+
+    table->added = (char*)cig_allocator_resize(table->allocator, table->added, table->added_capacity, capacity);
+    table->added_capacity = capacity;
+  }
+
+  i = piece_table_char_split(table, position);
+  previous = i > 0 ? &table->pieces[i - 1] : NULL;
+
+  /*  Typing continues the piece that was added last */
+  if (previous && previous->source == PIECE_ADDED && previous->start + previous->length == table->added_length) {
+    previous->length += count;
+    table->_cursor.piece = i - 1;
+    table->_cursor.start = position - (previous->length - count);
+  } else {
+    piece_table_char_insert_pieces(table, i, 1);
+    table->pieces[i] = (piece_table_piece) { PIECE_ADDED, table->added_length, count };
+  }
+
+  memcpy(table->added + table->added_length, text, count);
+  table->added_length += count;
+  table->length += count;
+}
+
+M_INLINED void
+piece_table_char_delete(piece_table_char *table, size_t position, size_t range)
+{
+  size_t first, last;
+
+  if (!range) {
+    return;
+  }
+
+  if (table->lines) {
+    line_index_deleted(table->lines, position, range);
+  }
+
+  first = piece_table_char_split(table, position);
+  last = piece_table_char_split(table, position + range);
+
+  memmove(&table->pieces[first], &table->pieces[last], sizeof(piece_table_piece) * (table->piece_count - last));
+  table->piece_count -= last - first;
+  table->length -= range;
+  table->_cursor.piece = first;
+  table->_cursor.start = position;
+}
+
+M_INLINED void
+piece_table_char_replace(piece_table_char *table, size_t position, size_t range, size_t count, const char text[])
+{
+  piece_table_char_delete(table, position, range);
+  piece_table_char_insert(table, position, count, text);
+}
+
+/*  ┌─────────┐
+    │ READING │
+    └─────────┘ */
+
+M_INLINED size_t
+piece_table_char_length(const piece_table_char *table)
+{
+  return table->length;
+}
+
+/* Iterates `count` characters from `position` as runs of contiguous text */
+M_INLINED piece_table_char_iterator
+piece_table_char_iterate(piece_table_char *table, size_t position, size_t count)
+{
+  piece_table_char_seek(table, position);
+
+  return (piece_table_char_iterator) {
+    .table = table,
+    .piece = table->_cursor.piece,
+    .offset = position - table->_cursor.start,
+    .remaining = count
+  };
+}
+
+/* @return False when there is no more text, otherwise sets `str` and `length`
+   to the next run. Runs point into the table and aren't NUL terminated */
+M_INLINED bool
+piece_table_char_next(piece_table_char_iterator *iter, const char **str, size_t *length)
+{
+  const piece_table_piece *piece;
+
+  if (!iter->remaining || iter->piece >= iter->table->piece_count) {
+    return false;
+  }
+
+  piece = &iter->table->pieces[iter->piece];
+  *str = piece_table_char_piece_text(iter->table, piece) + iter->offset;
+  *length = M_MIN(piece->length - iter->offset, iter->remaining);
+
+  iter->remaining -= *length;
+  iter->offset = 0;
+  iter->piece++;
+
+  return true;
+}
+
+/* Copies `count` characters from `position` into `out` */
+M_INLINED void
+piece_table_char_read(piece_table_char *table, size_t position, size_t count, char out[])
+{
+  piece_table_char_iterator iter = piece_table_char_iterate(table, position, count);
+  const char *str;
+  size_t length;
+
+  while (piece_table_char_next(&iter, &str, &length)) {
+    memcpy(out, str, length);
+    out += length;
+  }
+}
+
+/*  ┌────────────┐
+    │ LINE INDEX │
+    └────────────┘ */
+
+/* Indexes the lengths of lines into `lines`, which edits then keep up to
+   date. This is the only time the whole text is scanned.
+   @return False if there was no memory for even one line, `lines` isn't
+   attached then */
+M_INLINED bool
+piece_table_char_index_lines(piece_table_char *table, fenwick_tree *lines)
+{
+  piece_table_char_iterator iter = piece_table_char_iterate(table, 0, table->length);
+  const char *str;
+  size_t length, pending = 0;
+
+  fenwick_tree_clear(lines);
+  while (piece_table_char_next(&iter, &str, &length)) {
+    line_index_scan(lines, str, length, &pending);
+  }
+  line_index_finish(lines, pending);
+
+  if (!lines->count) {
+    return false;
+  }
+
+  table->lines = lines;
+  return true;
+}
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef CIG_TYPE_RECT_SIMD_INCLUDED
+#define CIG_TYPE_RECT_SIMD_INCLUDED
+
+#include <common/macros.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/*  SSE2 is part of x86-64 baseline, NEON of AArch64. Define CIG_NO_SIMD
+    to force the scalar versions everywhere */
+#if !defined(CIG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define RECT_SIMD_SSE2
+  #include <emmintrin.h>
+  #ifdef __SSE4_1__
+    #include <smmintrin.h>
+  #endif
+#elif !defined(CIG_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+  #define RECT_SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
+#ifdef RECT_SIMD_SSE2
+
+M_INLINED __m128i rect_simd__max_epi32(__m128i a, __m128i b) {
+#ifdef __SSE4_1__
+  return _mm_max_epi32(a, b);
+#else
+  const __m128i m = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+#endif
+}
+
+M_INLINED __m128i rect_simd__min_epi32(__m128i a, __m128i b) {
+#ifdef __SSE4_1__
+  return _mm_min_epi32(a, b);
+#else
+  const __m128i m = _mm_cmplt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+#endif
+}
+
+/*  Lanes 0 and 1 become x+w and y+h */
+M_INLINED __m128i rect_simd__end(__m128i r) {
+  return _mm_add_epi32(r, _mm_shuffle_epi32(r, _MM_SHUFFLE(3, 2, 3, 2)));
+}
+
+#endif
+
+/*  Vectorized versions of some rect<T> functions, plus batch forms that test
+    several rects against one. Only valid for rect types declared with a 32-bit
+    signed integer T, where the whole rect fits into a single 128-bit register.
+
+    Results are the same as with the scalar functions in `rect.h`, which are
+    also what these fall back to when no SIMD instruction set is available */
+#if defined(RECT_SIMD_SSE2)
+
+#define DECLARE_RECT_SIMD_T(DECLNAME, VEC2)                                                  \
+                                                                                             \
+M_INLINED bool DECLNAME##_intersects_simd(DECLNAME a, DECLNAME b) {                          \
+  const __m128i va = _mm_loadu_si128((const __m128i*)&a);                                    \
+  const __m128i vb = _mm_loadu_si128((const __m128i*)&b);                                    \
+  /* (ax, ay, bx, by) < (bx+bw, by+bh, ax+aw, ay+ah) */                                      \
+  const __m128i lo = _mm_unpacklo_epi64(va, vb);                                             \
+  const __m128i hi = _mm_unpacklo_epi64(rect_simd__end(vb), rect_simd__end(va));             \
+  return _mm_movemask_epi8(_mm_cmplt_epi32(lo, hi)) == 0xFFFF;                               \
+}                                                                                            \
+                                                                                             \
+M_INLINED DECLNAME DECLNAME##_union_simd(DECLNAME a, DECLNAME b) {                           \
+  DECLNAME result;                                                                           \
+  const __m128i va = _mm_loadu_si128((const __m128i*)&a);                                    \
+  const __m128i vb = _mm_loadu_si128((const __m128i*)&b);                                    \
+  const __m128i ea = rect_simd__end(va), eb = rect_simd__end(vb);                            \
+  const __m128i hit = _mm_cmplt_epi32(                                                       \
+    _mm_unpacklo_epi64(va, vb),                                                              \
+    _mm_unpacklo_epi64(eb, ea)                                                               \
+  );                                                                                         \
+  if (_mm_movemask_epi8(hit) != 0xFFFF) {                                                    \
+    return (DECLNAME) { 0 };                                                                 \
+  }                                                                                          \
+  const __m128i lo = rect_simd__max_epi32(va, vb);                                           \
+  const __m128i hi = rect_simd__min_epi32(ea, eb);                                           \
+  _mm_storeu_si128((__m128i*)&result, _mm_unpacklo_epi64(lo, _mm_sub_epi32(hi, lo)));        \
+  return result;                                                                             \
+}                                                                                            \
+                                                                                             \
+M_INLINED DECLNAME DECLNAME##_containing_simd(DECLNAME a, DECLNAME b) {                      \
+  DECLNAME result;                                                                           \
+  const __m128i va = _mm_loadu_si128((const __m128i*)&a);                                    \
+  const __m128i vb = _mm_loadu_si128((const __m128i*)&b);                                    \
+  const __m128i lo = rect_simd__min_epi32(va, vb);                                           \
+  const __m128i hi = rect_simd__max_epi32(rect_simd__end(va), rect_simd__end(vb));           \
+  _mm_storeu_si128((__m128i*)&result, _mm_unpacklo_epi64(lo, _mm_sub_epi32(hi, lo)));        \
+  return result;                                                                             \
+}                                                                                            \
+                                                                                             \
+M_INLINED bool DECLNAME##_contains_simd(DECLNAME f, VEC2 p) {                                \
+  const __m128i vf = _mm_loadu_si128((const __m128i*)&f);                                    \
+  const __m128i vp = _mm_loadl_epi64((const __m128i*)&p);                                    \
+  /* p < (x+w, y+h) and not (x, y) > p */                                                    \
+  const __m128i inside = _mm_andnot_si128(                                                   \
+    _mm_cmpgt_epi32(vf, vp),                                                                 \
+    _mm_cmplt_epi32(vp, rect_simd__end(vf))                                                  \
+  );                                                                                         \
+  return (_mm_movemask_epi8(inside) & 0xFF) == 0xFF;                                         \
+}                                                                                            \
+                                                                                             \
+/*  Tests 4 rects against `b`, bit N of the result is set if rects[N] intersects */          \
+M_INLINED int DECLNAME##_intersects_4(DECLNAME b, const DECLNAME *rects) {                   \
+  const __m128i r0 = _mm_loadu_si128((const __m128i*)&rects[0]);                             \
+  const __m128i r1 = _mm_loadu_si128((const __m128i*)&rects[1]);                             \
+  const __m128i r2 = _mm_loadu_si128((const __m128i*)&rects[2]);                             \
+  const __m128i r3 = _mm_loadu_si128((const __m128i*)&rects[3]);                             \
+  const __m128i t0 = _mm_unpacklo_epi32(r0, r1), t1 = _mm_unpacklo_epi32(r2, r3);            \
+  const __m128i t2 = _mm_unpackhi_epi32(r0, r1), t3 = _mm_unpackhi_epi32(r2, r3);            \
+  const __m128i x = _mm_unpacklo_epi64(t0, t1), y = _mm_unpackhi_epi64(t0, t1);              \
+  const __m128i w = _mm_unpacklo_epi64(t2, t3), h = _mm_unpackhi_epi64(t2, t3);              \
+  const __m128i bx = _mm_set1_epi32(b.x), bx1 = _mm_set1_epi32(b.x + b.w);                   \
+  const __m128i by = _mm_set1_epi32(b.y), by1 = _mm_set1_epi32(b.y + b.h);                   \
+  const __m128i hit = _mm_and_si128(                                                         \
+    _mm_and_si128(_mm_cmplt_epi32(x, bx1), _mm_cmplt_epi32(bx, _mm_add_epi32(x, w))),        \
+    _mm_and_si128(_mm_cmplt_epi32(y, by1), _mm_cmplt_epi32(by, _mm_add_epi32(y, h)))         \
+  );                                                                                         \
+  return _mm_movemask_ps(_mm_castsi128_ps(hit));                                             \
+}                                                                                            \
+                                                                                             \
+DECLARE_RECT_SIMD_BATCH_T(DECLNAME)
+
+#elif defined(RECT_SIMD_NEON)
+
+#define DECLARE_RECT_SIMD_T(DECLNAME, VEC2)                                                  \
+                                                                                             \
+M_INLINED bool DECLNAME##_intersects_simd(DECLNAME a, DECLNAME b) {                          \
+  const int32x2_t pa = vld1_s32((const int32_t*)&a.x), pb = vld1_s32((const int32_t*)&b.x);  \
+  const int32x2_t ea = vadd_s32(pa, vld1_s32((const int32_t*)&a.w));                        \
+  const int32x2_t eb = vadd_s32(pb, vld1_s32((const int32_t*)&b.w));                        \
+  const uint32x2_t hit = vand_u32(vclt_s32(pa, eb), vclt_s32(pb, ea));                       \
+  return vget_lane_u32(hit, 0) && vget_lane_u32(hit, 1);                                     \
+}                                                                                            \
+                                                                                             \
+M_INLINED DECLNAME DECLNAME##_union_simd(DECLNAME a, DECLNAME b) {                           \
+  DECLNAME result;                                                                           \
+  const int32x2_t pa = vld1_s32((const int32_t*)&a.x), pb = vld1_s32((const int32_t*)&b.x);  \
+  const int32x2_t ea = vadd_s32(pa, vld1_s32((const int32_t*)&a.w));                         \
+  const int32x2_t eb = vadd_s32(pb, vld1_s32((const int32_t*)&b.w));                         \
+  const int32x2_t lo = vmax_s32(pa, pb), hi = vmin_s32(ea, eb);                              \
+  const uint32x2_t hit = vand_u32(vclt_s32(pa, eb), vclt_s32(pb, ea));                       \
+  if (!(vget_lane_u32(hit, 0) && vget_lane_u32(hit, 1))) {                                   \
+    return (DECLNAME) { 0 };                                                                 \
+  }                                                                                          \
+  vst1q_s32((int32_t*)&result, vcombine_s32(lo, vsub_s32(hi, lo)));                          \
+  return result;                                                                             \
+}                                                                                            \
+                                                                                             \
+M_INLINED DECLNAME DECLNAME##_containing_simd(DECLNAME a, DECLNAME b) {                      \
+  DECLNAME result;                                                                           \
+  const int32x2_t pa = vld1_s32((const int32_t*)&a.x), pb = vld1_s32((const int32_t*)&b.x);  \
+  const int32x2_t lo = vmin_s32(pa, pb);                                                     \
+  const int32x2_t hi = vmax_s32(                                                             \
+    vadd_s32(pa, vld1_s32((const int32_t*)&a.w)),                                            \
+    vadd_s32(pb, vld1_s32((const int32_t*)&b.w))                                             \
+  );                                                                                         \
+  vst1q_s32((int32_t*)&result, vcombine_s32(lo, vsub_s32(hi, lo)));                          \
+  return result;                                                                             \
+}                                                                                            \
+                                                                                             \
+M_INLINED bool DECLNAME##_contains_simd(DECLNAME f, VEC2 p) {                                \
+  const int32x2_t pf = vld1_s32((const int32_t*)&f.x), vp = vld1_s32((const int32_t*)&p);    \
+  const int32x2_t ef = vadd_s32(pf, vld1_s32((const int32_t*)&f.w));                         \
+  const uint32x2_t inside = vand_u32(vcge_s32(vp, pf), vclt_s32(vp, ef));                    \
+  return vget_lane_u32(inside, 0) && vget_lane_u32(inside, 1);                               \
+}                                                                                            \
+                                                                                             \
+/*  Tests 4 rects against `b`, bit N of the result is set if rects[N] intersects */          \
+M_INLINED int DECLNAME##_intersects_4(DECLNAME b, const DECLNAME *rects) {                   \
+  const int32x4x4_t r = vld4q_s32((const int32_t*)rects);                                    \
+  const uint32x4_t hit = vandq_u32(                                                          \
+    vandq_u32(                                                                               \
+      vcltq_s32(r.val[0], vdupq_n_s32(b.x + b.w)),                                           \
+      vcltq_s32(vdupq_n_s32(b.x), vaddq_s32(r.val[0], r.val[2]))                             \
+    ),                                                                                       \
+    vandq_u32(                                                                               \
+      vcltq_s32(r.val[1], vdupq_n_s32(b.y + b.h)),                                           \
+      vcltq_s32(vdupq_n_s32(b.y), vaddq_s32(r.val[1], r.val[3]))                             \
+    )                                                                                        \
+  );                                                                                         \
+  return (vgetq_lane_u32(hit, 0) & 1)                                                        \
+    | (vgetq_lane_u32(hit, 1) & 2)                                                           \
+    | (vgetq_lane_u32(hit, 2) & 4)                                                           \
+    | (vgetq_lane_u32(hit, 3) & 8);                                                          \
+}                                                                                            \
+                                                                                             \
+DECLARE_RECT_SIMD_BATCH_T(DECLNAME)
+
+#else
+
+#define DECLARE_RECT_SIMD_T(DECLNAME, VEC2)                                                  \
+                                                                                             \
+M_INLINED bool DECLNAME##_intersects_simd(DECLNAME a, DECLNAME b) {                          \
+  return DECLNAME##_intersects(a, b);                                                        \
+}                                                                                            \
+                                                                                             \
+M_INLINED DECLNAME DECLNAME##_union_simd(DECLNAME a, DECLNAME b) {                           \
+  return DECLNAME##_union(a, b);                                                             \
+}                                                                                            \
+                                                                                             \
+M_INLINED DECLNAME DECLNAME##_containing_simd(DECLNAME a, DECLNAME b) {                      \
+  return DECLNAME##_containing(a, b);                                                        \
+}                                                                                            \
+                                                                                             \
+M_INLINED bool DECLNAME##_contains_simd(DECLNAME f, VEC2 p) {                                \
+  return DECLNAME##_contains(f, p);                                                          \
+}                                                                                            \
+                                                                                             \
+M_INLINED int DECLNAME##_intersects_4(DECLNAME b, const DECLNAME *rects) {                   \
+  return DECLNAME##_intersects(rects[0], b)                                                  \
+    | (DECLNAME##_intersects(rects[1], b) << 1)                                              \
+    | (DECLNAME##_intersects(rects[2], b) << 2)                                              \
+    | (DECLNAME##_intersects(rects[3], b) << 3);                                             \
+}                                                                                            \
+                                                                                             \
+DECLARE_RECT_SIMD_BATCH_T(DECLNAME)
+
+#endif
+
+/*  4-bit mask to 4 bools */
+static const bool rect_simd__mask_bytes[16][4] = {
+  { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 1, 1, 0, 0 },
+  { 0, 0, 1, 0 }, { 1, 0, 1, 0 }, { 0, 1, 1, 0 }, { 1, 1, 1, 0 },
+  { 0, 0, 0, 1 }, { 1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 1, 1, 0, 1 },
+  { 0, 0, 1, 1 }, { 1, 0, 1, 1 }, { 0, 1, 1, 1 }, { 1, 1, 1, 1 }
+};
+
+/*  Shared by all of the above. Writes whether each of the `n` rects intersects `b` */
+#define DECLARE_RECT_SIMD_BATCH_T(DECLNAME)                                                  \
+                                                                                             \
+M_INLINED void                                                                               \
+DECLNAME##_intersects_n(DECLNAME b, const DECLNAME *rects, size_t n, bool *result) {         \
+  size_t i = 0;                                                                              \
+  for (; i + 4 <= n; i += 4) {                                                               \
+    memcpy(&result[i], rect_simd__mask_bytes[DECLNAME##_intersects_4(b, &rects[i])], 4);     \
+  }                                                                                          \
+  for (; i < n; ++i) {                                                                       \
+    result[i] = DECLNAME##_intersects_simd(rects[i], b);                                     \
+  }                                                                                          \
+}
+
+#endif
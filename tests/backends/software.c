@@ -0,0 +1,160 @@
+#include "unity.h"
+#include "fixture.h"
+#include "cigsoftware.h"
+#include "cigcorem.h"
+#include "asserts.h"
+#include "allocator.h"
+
+TEST_GROUP(software_backend);
+
+#define FB_W 64
+#define FB_H 32
+
+static cig_context ctx;
+static uint32_t pixels[FB_W * FB_H];
+static cig_sw_framebuffer fb;
+static cig_sw_font font;
+
+static const uint32_t white = CIG_SW_RGBA(255, 255, 255, 255);
+static const uint32_t black = CIG_SW_RGBA(0, 0, 0, 255);
+static const uint32_t red = CIG_SW_RGBA(255, 0, 0, 255);
+
+static size_t count_pixels(cig_r rect, uint32_t color) {
+  int x, y;
+  size_t count = 0;
+  for (y = rect.y; y < rect.y + rect.h; ++y) {
+    for (x = rect.x; x < rect.x + rect.w; ++x) {
+      count += pixels[y * FB_W + x] == color;
+    }
+  }
+  return count;
+}
+
+TEST_SETUP(software_backend) {
+  cig_init_context(&ctx);
+  set_up_test_allocator(&ctx);
+  cig_sw_assign_callbacks();
+  font = cig_sw_default_font(1);
+  cig_set_default_font(&font);
+  cig_set_default_text_color((cig_text_color_ref)&black);
+  cig_sw_framebuffer_init(&fb, pixels, FB_W, FB_H);
+  cig_sw_clear(&fb, white);
+}
+
+TEST_TEAR_DOWN(software_backend) {}
+
+/*  ┌────────────┐
+    │ TEST CASES │
+    └────────────┘ */
+
+TEST(software_backend, fill_rect) {
+  int w;
+
+  /*  Spans of every length around the vector width are filled exactly */
+  for (w = 0; w <= 17; ++w) {
+    cig_sw_clear(&fb, white);
+    cig_sw_fill_rect(&fb, cig_r_make(3, 1, w, 2), red);
+    TEST_ASSERT_EQUAL_UINT(w * 2, count_pixels(cig_r_make(0, 0, FB_W, FB_H), red));
+    TEST_ASSERT_EQUAL_UINT(w * 2, count_pixels(cig_r_make(3, 1, w, 2), red));
+  }
+
+  /*  Rects are clipped to the framebuffer */
+  cig_sw_clear(&fb, white);
+  cig_sw_fill_rect(&fb, cig_r_make(-10, -10, 20, 20), red);
+  TEST_ASSERT_EQUAL_UINT(100, count_pixels(cig_r_make(0, 0, FB_W, FB_H), red));
+}
+
+TEST(software_backend, clipping) {
+  cig_begin_layout(&ctx, &fb, cig_r_make(0, 0, FB_W, FB_H), 0.1f);
+
+  CIG(cig_r_make(10, 10, 8, 8)) {
+    cig_enable_clipping();
+    cig_sw_fill_rect(&fb, cig_r_make(0, 0, FB_W, FB_H), red);
+  }
+
+  TEST_ASSERT_EQUAL_UINT(64, count_pixels(cig_r_make(0, 0, FB_W, FB_H), red));
+  TEST_ASSERT_EQUAL_UINT(64, count_pixels(cig_r_make(10, 10, 8, 8), red));
+
+  /*  Clip is reset once the clipped frame is closed */
+  TEST_ASSERT_EQUAL_RECT(cig_r_make(0, 0, FB_W, FB_H), fb.clip);
+
+  cig_end_layout();
+}
+
+TEST(software_backend, text) {
+  const cig_sw_font big = cig_sw_default_font(2);
+
+  TEST_ASSERT_EQUAL_VEC2(cig_v_make(30, 8), cig_measure_raw_text(NULL, 0, "Hello"));
+  TEST_ASSERT_EQUAL_VEC2(cig_v_make(60, 16), cig_measure_raw_text((cig_font_ref)&big, 0, "Hello"));
+
+  /*  Multibyte characters take a single cell */
+  TEST_ASSERT_EQUAL_VEC2(cig_v_make(18, 8), cig_measure_raw_text(NULL, 0, "\xC3\xA9t\xC3\xA9"));
+
+  cig_begin_layout(&ctx, &fb, cig_r_make(0, 0, FB_W, FB_H), 0.1f);
+
+  /*  Label is clipped to the first 3 characters */
+  CIG(cig_r_make(0, 0, 18, 8)) {
+    cig_enable_clipping();
+    cig_draw_label((cig_text_properties) {
+      .alignment.horizontal = CIG_TEXT_ALIGN_LEFT,
+      .alignment.vertical = CIG_TEXT_ALIGN_TOP,
+      .flags = CIG_TEXT_HORIZONTAL_WRAP_DISABLED
+    }, "HHHHH");
+  }
+
+  cig_end_layout();
+
+  /*  'H' is 7 + 7 + 3 pixels */
+  TEST_ASSERT_EQUAL_UINT(17 * 3, count_pixels(cig_r_make(0, 0, FB_W, FB_H), black));
+}
+
+TEST(software_backend, image) {
+  const uint32_t image_pixels[] = {
+    red, black,
+    black, CIG_SW_RGBA(0, 0, 255, 0)
+  };
+  cig_sw_image image = { image_pixels, 2, 2 };
+
+  cig_begin_layout(&ctx, &fb, cig_r_make(0, 0, FB_W, FB_H), 0.1f);
+
+  CIG(cig_r_make(4, 4, 8, 8)) {
+    cig_draw_image(&image, CIG_IMAGE_MODE_SCALE_TO_FILL);
+  }
+
+  cig_end_layout();
+
+  /*  Scaled up by 4, transparent quarter is not drawn */
+  TEST_ASSERT_EQUAL_UINT(16, count_pixels(cig_r_make(4, 4, 4, 4), red));
+  TEST_ASSERT_EQUAL_UINT(32, count_pixels(cig_r_make(0, 0, FB_W, FB_H), black));
+  TEST_ASSERT_EQUAL_UINT(16, count_pixels(cig_r_make(8, 8, 4, 4), white));
+}
+
+static uint32_t render_screen(const char *title) {
+  cig_sw_clear(&fb, white);
+  cig_begin_layout(&ctx, &fb, cig_r_make(0, 0, FB_W, FB_H), 0.1f);
+
+  CIG(cig_r_make(2, 2, FB_W - 4, 12)) {
+    cig_sw_fill_rect(&fb, cig_absolute_rect(), red);
+    cig_draw_label((cig_text_properties) { 0 }, title);
+  }
+
+  cig_end_layout();
+
+  return cig_sw_hash(&fb);
+}
+
+TEST(software_backend, screenshot) {
+  const uint32_t hash = render_screen("Title");
+
+  /*  Rendering is deterministic, and any change shows in the hash */
+  TEST_ASSERT_EQUAL_HEX32(hash, render_screen("Title"));
+  TEST_ASSERT_NOT_EQUAL(hash, render_screen("Titel"));
+}
+
+TEST_GROUP_RUNNER(software_backend) {
+  RUN_TEST_CASE(software_backend, fill_rect);
+  RUN_TEST_CASE(software_backend, clipping);
+  RUN_TEST_CASE(software_backend, text);
+  RUN_TEST_CASE(software_backend, image);
+  RUN_TEST_CASE(software_backend, screenshot);
+}
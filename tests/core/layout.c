@@ -791,6 +791,113 @@ TEST(core_layout, vstack_scroll) {
   TEST_ASSERT_EQUAL_VEC2(cig_v_make(640, 1000), scroll->bounds);
 }
 
+typedef struct {
+  size_t count;
+  size_t index[64];
+  cig_id id[64];
+  cig_r rect[64];
+} batch_record_t;
+
+static void record_batch_frame(size_t index, cig_frame *frame, void *user_data) {
+  batch_record_t *record = (batch_record_t*)user_data;
+  record->index[record->count] = index;
+  record->id[record->count] = frame->id;
+  record->rect[record->count] = frame->rect;
+  record->count ++;
+}
+
+static void push_batch_test_parents(int layout) {
+  if (layout == 0) {
+    /* Vertical stack with scrolling, items partially culled at both ends */
+    cig_push_vstack(cig_r_make(0, 0, 200, 300), cig_i_zero(), (cig_params) { .height = 40, .spacing = { 0, 5 } });
+    cig_enable_scroll(NULL);
+    cig_set_offset(cig_v_make(0, 100));
+  } else if (layout == 1) {
+    /* Horizontal stack, some items don't fit */
+    cig_push_hstack(cig_r_make(0, 0, 300, 50), cig_i_make(5, 5, 5, 5), (cig_params) { .spacing = { 10, 0 } });
+  } else {
+    /* Grid that wraps rows and overflows its bounds */
+    cig_push_grid(cig_r_make(0, 0, 250, 120), cig_i_zero(), (cig_params) { .width = 60, .height = 50 });
+  }
+}
+
+TEST(core_layout, batch_push) {
+  int layout;
+  size_t i;
+
+  for (layout = 0; layout < 3; ++layout) {
+    batch_record_t individual = { 0 }, batched = { 0 };
+    const cig_r item = layout == 1 ? RECT_AUTO_W(40) : RECT_AUTO;
+
+    /*  Push children one by one */
+    push_batch_test_parents(layout);
+    for (i = 0; i < 40; ++i) {
+      cig_frame *frame = cig_push_frame(item);
+      if (frame) {
+        record_batch_frame(i, frame, &individual);
+        cig_pop_frame();
+      }
+    }
+    const cig_r content_rect = cig_current()->content_rect;
+    const cig_params params = cig_current()->_layout_params;
+    cig_pop_frame();
+
+    cig_end_layout();
+    cig_begin_layout(&ctx, &main_buffer, cig_r_make(0, 0, 640, 480), 0.1f);
+
+    /*  Same children in one batch should result in the same frames and layout state */
+    push_batch_test_parents(layout);
+    TEST_ASSERT_EQUAL_UINT(individual.count, cig_push_frames_n(40, item, &record_batch_frame, &batched));
+    TEST_ASSERT_EQUAL_RECT(content_rect, cig_current()->content_rect);
+    TEST_ASSERT_EQUAL_INT(params._h_pos, cig_current()->_layout_params._h_pos);
+    TEST_ASSERT_EQUAL_INT(params._v_pos, cig_current()->_layout_params._v_pos);
+    TEST_ASSERT_EQUAL_INT(params._count.total, cig_current()->_layout_params._count.total);
+    TEST_ASSERT_EQUAL_INT(params._count.h_cur, cig_current()->_layout_params._count.h_cur);
+    TEST_ASSERT_EQUAL_INT(params._count.v_cur, cig_current()->_layout_params._count.v_cur);
+    cig_pop_frame();
+
+    TEST_ASSERT_TRUE(batched.count > 0);
+    TEST_ASSERT_EQUAL_UINT(individual.count, batched.count);
+
+    for (i = 0; i < batched.count; ++i) {
+      TEST_ASSERT_EQUAL_UINT(individual.index[i], batched.index[i]);
+      TEST_ASSERT_EQUAL_UINT32(individual.id[i], batched.id[i]);
+      TEST_ASSERT_EQUAL_RECT(individual.rect[i], batched.rect[i]);
+    }
+
+    cig_end_layout();
+    cig_begin_layout(&ctx, &main_buffer, cig_r_make(0, 0, 640, 480), 0.1f);
+  }
+}
+
+TEST(core_layout, stats) {
+  register int i;
+
+  cig_push_vstack(cig_r_make(0, 0, 200, 100), cig_i_zero(), (cig_params) { .height = 30 });
+  cig_enable_clipping();
+
+  /*  4 of these fit into the stack, 6 are culled */
+  for (i = 0; i < 10; ++i) {
+    if (cig_push_frame(RECT_AUTO)) {
+      cig_pop_frame();
+    }
+  }
+
+  cig_pop_frame();
+
+  TEST_ASSERT_EQUAL_UINT(5, cig_stats()->frames.pushed);
+  TEST_ASSERT_EQUAL_UINT(6, cig_stats()->frames.culled);
+  TEST_ASSERT_EQUAL_UINT(1, cig_stats()->clip_pushes);
+
+  /*  Counters start over on every tick */
+  cig_end_layout();
+  cig_begin_layout(&ctx, &main_buffer, cig_r_make(0, 0, 640, 480), 0.1f);
+
+  TEST_ASSERT_EQUAL_UINT(0, cig_stats()->frames.pushed);
+  TEST_ASSERT_EQUAL_UINT(0, cig_stats()->frames.culled);
+  TEST_ASSERT_EQUAL_UINT(0, cig_stats()->clip_pushes);
+}
+
 TEST(core_layout, clipping) {
   /*  Clipping is partially a graphical feature implemented in the backend,
       but the layout elements also calculate a relative frame that's been clipped.
@@ -1286,6 +1393,8 @@ TEST_GROUP_RUNNER(core_layout)
   RUN_TEST_CASE(core_layout, grid_with_flipped_alignment_and_direction);
   RUN_TEST_CASE(core_layout, grid_with_minimum);
   RUN_TEST_CASE(core_layout, vstack_scroll);
+  RUN_TEST_CASE(core_layout, batch_push);
+  RUN_TEST_CASE(core_layout, stats);
   RUN_TEST_CASE(core_layout, clipping);
   RUN_TEST_CASE(core_layout, additional_buffers);
   RUN_TEST_CASE(core_layout, main_screen_subregion);
@@ -0,0 +1,158 @@
+#include "unity.h"
+#include "fixture.h"
+#include "cigcore.h"
+#include "asserts.h"
+#include "allocator.h"
+#include <string.h>
+
+#ifdef CIG_PROFILE
+
+TEST_GROUP(core_profile);
+
+static cig_context ctx = { 0 };
+static uint64_t fake_time;
+
+/*  Every clock read advances time by 1 microsecond */
+static uint64_t fake_clock(void) {
+  return (fake_time += 1000);
+}
+
+TEST_SETUP(core_profile) {
+  cig_init_context(&ctx);
+  set_up_test_allocator(&ctx);
+  cig_assign_profile_clock(&fake_clock);
+  fake_time = 0;
+}
+
+TEST_TEAR_DOWN(core_profile) {
+  cig_assign_profile_clock(NULL);
+}
+
+static void user_function() {
+  CIG_PROFILE_ZONE("user_function");
+  cig_push_frame(RECT_AUTO);
+  cig_pop_frame();
+}
+
+/*  ┌────────────┐
+    │ TEST CASES │
+    └────────────┘ */
+
+TEST(core_profile, zones) {
+  cig_begin_layout(&ctx, NULL, cig_r_make(0, 0, 640, 480), 0.1f);
+  user_function();
+  cig_end_layout();
+
+  /*  User zone, the frame push within it, and end of layout */
+  TEST_ASSERT_EQUAL_UINT(3, cig_profile_zone_count());
+
+  TEST_ASSERT_EQUAL_STRING("user_function", cig_profile_zone(0)->name);
+  TEST_ASSERT_EQUAL_UINT(0, cig_profile_zone(0)->depth);
+  TEST_ASSERT_EQUAL_STRING("push_frame", cig_profile_zone(1)->name);
+  TEST_ASSERT_EQUAL_UINT(1, cig_profile_zone(1)->depth);
+  TEST_ASSERT_EQUAL_STRING("cig_end_layout", cig_profile_zone(2)->name);
+  TEST_ASSERT_EQUAL_UINT(0, cig_profile_zone(2)->depth);
+
+  /*  Nested zone is contained within its parent */
+  TEST_ASSERT_TRUE(cig_profile_zone(1)->start > cig_profile_zone(0)->start);
+  TEST_ASSERT_TRUE(cig_profile_zone(1)->end < cig_profile_zone(0)->end);
+}
+
+TEST(core_profile, ring_buffer) {
+  size_t i;
+
+  cig_begin_layout(&ctx, NULL, cig_r_make(0, 0, 640, 480), 0.1f);
+
+  for (i = 0; i < CIG_PROFILE_ZONES_MAX + 10; ++i) {
+    cig_profile_end(cig_profile_begin(i < 10 ? "old" : "new"));
+  }
+
+  /*  Oldest zones have been overwritten */
+  TEST_ASSERT_EQUAL_UINT(CIG_PROFILE_ZONES_MAX, cig_profile_zone_count());
+  TEST_ASSERT_EQUAL_STRING("new", cig_profile_zone(0)->name);
+
+  cig_profile_clear();
+  TEST_ASSERT_EQUAL_UINT(0, cig_profile_zone_count());
+
+  cig_end_layout();
+}
+
+TEST(core_profile, chrome_trace) {
+  char json[512] = { 0 };
+
+  cig_begin_layout(&ctx, NULL, cig_r_make(0, 0, 640, 480), 0.1f);
+  cig_profile_end(cig_profile_begin("a \"zone\""));
+
+  FILE *file = tmpfile();
+  TEST_ASSERT_EQUAL_UINT(1, cig_profile_write_trace(file));
+  rewind(file);
+  M_UNUSED(fread(json, 1, sizeof(json) - 1, file));
+  fclose(file);
+
+  cig_end_layout();
+
+  TEST_ASSERT_EQUAL_STRING(
+    "{\"traceEvents\":[\n"
+    "{\"name\":\"a \\\"zone\\\"\",\"cat\":\"cig\",\"ph\":\"X\",\"ts\":1.000,\"dur\":1.000,\"pid\":1,\"tid\":1}\n"
+    "],\"displayTimeUnit\":\"ns\"}\n",
+    json
+  );
+}
+
+TEST(core_profile, cost_report) {
+  size_t count;
+  int i;
+
+  cig_begin_layout(&ctx, NULL, cig_r_make(0, 0, 640, 480), 0.1f);
+
+  cig_retain(cig_push_frame(RECT_AUTO)); /* A */
+    cig_push_frame(RECT_AUTO);
+    cig_pop_frame();
+    cig_push_frame(RECT_AUTO); /* B */
+      cig_cost_tag("B");
+      TEST_ASSERT_NOT_NULL(cig_memory_allocate(64));
+      for (i = 0; i < 3; ++i) {
+        cig_push_frame(RECT_AUTO);
+        cig_pop_frame();
+      }
+    cig_pop_frame();
+  cig_pop_frame();
+
+  /*  Frames outside attributed subtrees are not counted */
+  cig_push_frame(RECT_AUTO);
+  cig_pop_frame();
+
+  const cig_cost_entry_t *report = cig_cost_report(&count);
+
+  cig_end_layout();
+
+  TEST_ASSERT_EQUAL_UINT(2, count);
+
+  /*  Parent subtree is more expensive and comes first */
+  TEST_ASSERT_NULL(report[0].name);
+  TEST_ASSERT_EQUAL_UINT(0, report[0].depth);
+  TEST_ASSERT_EQUAL_UINT(2, report[0].self.frames);
+  TEST_ASSERT_EQUAL_UINT(5, report[0].total.frames);
+  TEST_ASSERT_EQUAL_UINT(0, report[0].self.allocated_bytes);
+  TEST_ASSERT_EQUAL_UINT(64, report[0].total.allocated_bytes);
+
+  TEST_ASSERT_EQUAL_STRING("B", report[1].name);
+  TEST_ASSERT_EQUAL_UINT(report[0].id, report[1].parent);
+  TEST_ASSERT_EQUAL_UINT(1, report[1].depth);
+  TEST_ASSERT_EQUAL_UINT(3, report[1].self.frames);
+  TEST_ASSERT_EQUAL_UINT(3, report[1].total.frames);
+  TEST_ASSERT_EQUAL_UINT(64, report[1].self.allocated_bytes);
+
+  TEST_ASSERT_TRUE(report[1].total.time > 0);
+  TEST_ASSERT_TRUE(report[0].total.time > report[1].total.time);
+  TEST_ASSERT_EQUAL_UINT64(report[0].total.time - report[1].total.time, report[0].self.time);
+}
+
+TEST_GROUP_RUNNER(core_profile) {
+  RUN_TEST_CASE(core_profile, zones);
+  RUN_TEST_CASE(core_profile, ring_buffer);
+  RUN_TEST_CASE(core_profile, chrome_trace);
+  RUN_TEST_CASE(core_profile, cost_report);
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "unity.h"
+#include "fixture.h"
+#include "cigcore.h"
+#include "cigrecord.h"
+#include "asserts.h"
+#include <string.h>
+
+TEST_GROUP(core_record);
+
+static cig_context ctx = { 0 };
+static cig_recorder recorder;
+static unsigned char log_bytes[4096];
+static size_t log_size;
+
+static void write_log(const void *bytes, size_t size, void *user_data) {
+  TEST_ASSERT_LESS_OR_EQUAL(sizeof(log_bytes), log_size + size);
+  memcpy(&log_bytes[log_size], bytes, size);
+  log_size += size;
+}
+
+TEST_SETUP(core_record) {
+  cig_init_context(&ctx);
+  cig_set_key_repeat_rate(0);
+  log_size = 0;
+}
+
+TEST_TEAR_DOWN(core_record) {
+  cig_record_stop();
+}
+
+/*  Presses the button on tick 2 and releases it on tick 3, typing a key
+    in between. Every key is reported on every tick like most platform
+    layers do. Returns how many ticks the button was clicked on */
+static int run_session(bool replaying, cig_replay *replay) {
+  int tick, clicks = 0;
+
+  for (tick = 0; tick < 5; ++tick) {
+    if (replaying) {
+      TEST_ASSERT_TRUE(cig_replay_tick(replay, &ctx, NULL));
+    } else {
+      int key;
+      cig_begin_layout(&ctx, NULL, cig_r_make(0, 0, 640, 480), 0.1f + tick * 0.01f);
+      cig_set_pointer_position(cig_v_make(20 + tick * 10, 25 - tick));
+      cig_set_pointer_state(tick == 2 ? CIG_INPUT_PRIMARY_ACTION : 0);
+      for (key = 0; key < CIG__KEY_COUNT; ++key) {
+        cig_set_key_state(key, key == CIG_KEY_A && tick == 2);
+      }
+    }
+
+    cig_push_frame(cig_r_make(0, 0, 100, 100));
+    cig_enable_interaction();
+    if (cig_clicked(CIG_INPUT_PRIMARY_ACTION, CIG_CLICK_STARTS_INSIDE)) {
+      clicks++;
+    }
+    if (tick == 2) {
+      TEST_ASSERT_TRUE(cig_input_state()->key.code[CIG_KEY_A].state & CIG_KEY_CLICKED);
+    }
+    cig_pop_frame();
+    cig_end_layout();
+  }
+
+  return clicks;
+}
+
+/*  ┌────────────┐
+    │ TEST CASES │
+    └────────────┘ */
+
+TEST(core_record, replay) {
+  cig_replay replay;
+
+  cig_record_start(&recorder, &write_log, NULL);
+  TEST_ASSERT_EQUAL_INT(1, run_session(false, NULL));
+  cig_record_stop();
+
+  const cig_v pointer = cig_input_state()->pointer.position;
+  const float elapsed = cig_elapsed_time();
+
+  /*  Unchanged keys aren't stored, so the whole session is tiny */
+  TEST_ASSERT_EQUAL_UINT(log_size, recorder.bytes_written);
+  TEST_ASSERT_LESS_THAN(128, log_size);
+
+  cig_init_context(&ctx);
+  TEST_ASSERT_TRUE(cig_replay_init(&replay, log_bytes, log_size));
+  TEST_ASSERT_EQUAL_INT(1, run_session(true, &replay));
+  TEST_ASSERT_EQUAL_UINT(5, replay.ticks);
+
+  /*  End of the log */
+  TEST_ASSERT_FALSE(cig_replay_tick(&replay, &ctx, NULL));
+
+  TEST_ASSERT_EQUAL_VEC2(pointer, cig_input_state()->pointer.position);
+  TEST_ASSERT_EQUAL_FLOAT(elapsed, cig_elapsed_time());
+}
+
+TEST(core_record, invalid_log) {
+  cig_replay replay;
+  const unsigned char truncated[] = { 'C', 'I', 'G', 'R', CIG_RECORD_VERSION, 1, 0, 0 };
+
+  TEST_ASSERT_FALSE(cig_replay_init(&replay, "CIGX\1", 5));
+  TEST_ASSERT_FALSE(cig_replay_init(&replay, "CIG", 3));
+
+  TEST_ASSERT_TRUE(cig_replay_init(&replay, truncated, sizeof(truncated)));
+  TEST_ASSERT_FALSE(cig_replay_tick(&replay, &ctx, NULL));
+}
+
+TEST_GROUP_RUNNER(core_record) {
+  RUN_TEST_CASE(core_record, replay);
+  RUN_TEST_CASE(core_record, invalid_log);
+}
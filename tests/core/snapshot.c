@@ -0,0 +1,133 @@
+#include "unity.h"
+#include "fixture.h"
+#include "cigcore.h"
+#include "cigsnapshot.h"
+#include "asserts.h"
+#include <string.h>
+
+TEST_GROUP(core_snapshot);
+
+static cig_context ctx = { 0 };
+static cig_snapshot snapshot;
+static unsigned char file_bytes[4096];
+static size_t file_size;
+
+static void write_file(const void *bytes, size_t size, void *user_data) {
+  TEST_ASSERT_LESS_OR_EQUAL(sizeof(file_bytes), file_size + size);
+  memcpy(&file_bytes[file_size], bytes, size);
+  file_size += size;
+}
+
+TEST_SETUP(core_snapshot) {
+  cig_init_context(&ctx);
+  file_size = 0;
+}
+
+TEST_TEAR_DOWN(core_snapshot) {
+  cig_snapshot_stop();
+}
+
+/*  Stack with two children, the second one nested */
+static void build(int spacing) {
+  cig_begin_layout(&ctx, NULL, cig_r_make(0, 0, 100, 100), 0.1f);
+
+  if (cig_push_vstack(RECT_AUTO, cig_i_uniform(2), (cig_params) { .spacing = { 0, spacing } })) {
+    if (cig_push_frame(RECT_AUTO_H(10))) {
+      cig_pop_frame();
+    }
+    if (cig_push_frame(RECT_AUTO_H(20))) {
+      if (cig_push_frame(cig_r_make(5, 5, 10, 10))) {
+        cig_pop_frame();
+      }
+      cig_pop_frame();
+    }
+    cig_pop_frame();
+  }
+
+  cig_end_layout();
+  cig_snapshot_end_tick();
+}
+
+/*  ┌────────────┐
+    │ TEST CASES │
+    └────────────┘ */
+
+TEST(core_snapshot, records) {
+  size_t count;
+
+  cig_snapshot_start(&snapshot, &write_file, NULL);
+  build(0);
+  cig_snapshot_stop();
+
+  const cig_snapshot_record *records = cig_snapshot_records(file_bytes, file_size, &count);
+
+  TEST_ASSERT_NOT_NULL(records);
+  TEST_ASSERT_EQUAL_UINT(5, count);
+  TEST_ASSERT_EQUAL_UINT(4, snapshot.frames);
+  TEST_ASSERT_EQUAL_UINT(1, snapshot.ticks);
+
+  /*  Children are written before their parent */
+  const cig_snapshot_record *stack = &records[3], *second = &records[2], *nested = &records[1];
+
+  TEST_ASSERT_EQUAL(CIG_SNAPSHOT_FRAME, stack->kind);
+  TEST_ASSERT_EQUAL_UINT(1, stack->depth);
+  TEST_ASSERT_EQUAL_UINT(2, second->depth);
+  TEST_ASSERT_EQUAL_UINT(3, nested->depth);
+  TEST_ASSERT_EQUAL_UINT64(stack->id, records[0].parent);
+  TEST_ASSERT_EQUAL_UINT64(stack->id, second->parent);
+  TEST_ASSERT_EQUAL_UINT64(second->id, nested->parent);
+
+  TEST_ASSERT_EQUAL_RECT(cig_r_make(0, 10, 96, 20), second->rect);
+  TEST_ASSERT_EQUAL_RECT(cig_r_make(2, 12, 96, 20), second->absolute_rect);
+  TEST_ASSERT_EQUAL_RECT(cig_r_make(7, 17, 10, 10), nested->absolute_rect);
+
+  TEST_ASSERT_EQUAL(CIG_SNAPSHOT_TICK, records[4].kind);
+  TEST_ASSERT_EQUAL_UINT64(0, records[4].id);
+  TEST_ASSERT_EQUAL_UINT64(4, records[4].parent);
+}
+
+TEST(core_snapshot, identical_layouts) {
+  unsigned char first[4096];
+  size_t first_size;
+
+  cig_snapshot_start(&snapshot, &write_file, NULL);
+  build(0);
+  cig_snapshot_stop();
+
+  memcpy(first, file_bytes, file_size);
+  first_size = file_size;
+
+  /*  Same layout in a new context gives the same bytes */
+  cig_init_context(&ctx);
+  file_size = 0;
+  cig_snapshot_start(&snapshot, &write_file, NULL);
+  build(0);
+  cig_snapshot_stop();
+
+  TEST_ASSERT_EQUAL_UINT(first_size, file_size);
+  TEST_ASSERT_EQUAL_MEMORY(first, file_bytes, file_size);
+
+  /*  Spacing moves the second child */
+  cig_init_context(&ctx);
+  file_size = 0;
+  cig_snapshot_start(&snapshot, &write_file, NULL);
+  build(1);
+  cig_snapshot_stop();
+
+  TEST_ASSERT_EQUAL_UINT(first_size, file_size);
+  TEST_ASSERT_NOT_EQUAL(0, memcmp(first, file_bytes, file_size));
+}
+
+TEST(core_snapshot, invalid_file) {
+  size_t count;
+  const uint32_t other_version[4] = { 0x53474943, CIG_SNAPSHOT_VERSION + 1, sizeof(cig_snapshot_record), 0 };
+
+  TEST_ASSERT_NULL(cig_snapshot_records("CIG", 3, &count));
+  TEST_ASSERT_NULL(cig_snapshot_records(other_version, sizeof(other_version), &count));
+}
+
+TEST_GROUP_RUNNER(core_snapshot) {
+  RUN_TEST_CASE(core_snapshot, records);
+  RUN_TEST_CASE(core_snapshot, identical_layouts);
+  RUN_TEST_CASE(core_snapshot, invalid_file);
+}
@@ -8,9 +8,16 @@ static void run_all_tests(void) {
   RUN_TEST_GROUP(core_state);
   RUN_TEST_GROUP(core_input);
   RUN_TEST_GROUP(core_macros);
+  RUN_TEST_GROUP(core_record);
+  RUN_TEST_GROUP(core_snapshot);
+#ifdef CIG_PROFILE
+  RUN_TEST_GROUP(core_profile);
+#endif
   RUN_TEST_GROUP(text_label);
   RUN_TEST_GROUP(text_style);
+  RUN_TEST_GROUP(text_view);
   RUN_TEST_GROUP(gfx_image);
+  RUN_TEST_GROUP(software_backend);
 }
 
 int main(int argc, const char *argv[]) {
@@ -11,8 +11,8 @@ TEST_GROUP(text_label);
 static cig_context ctx;
 static int text_measure_calls;
 static struct {
-  cig_r rects[16];
-  char strings[16][128];
+  cig_r rects[64];
+  char strings[64][128];
   size_t render_count;
 } spans;
 
@@ -30,6 +30,18 @@ M_INLINED void text_render(
   sprintf(spans.strings[i], "%.*s", (uint32_t)len, str);
 }
 
+static struct {
+  cig_placed_span spans[8];
+  size_t count,
+         calls;
+} batch;
+
+static void text_render_batch(const cig_placed_span *spans, size_t count) {
+  memcpy(&batch.spans[batch.count], spans, sizeof(cig_placed_span) * count);
+  batch.count += count;
+  batch.calls ++;
+}
+
 M_INLINED cig_v text_measure(
   const char *str,
   size_t len,
@@ -61,7 +73,9 @@ TEST_SETUP(text_label) {
   text_measure_calls = 0;
 }
 
-TEST_TEAR_DOWN(text_label) {}
+TEST_TEAR_DOWN(text_label) {
+  cig_assign_draw_text_batch(NULL);
+}
 
 static void begin() {
   /*  In the context of these tests we work with a terminal/text-mode where
@@ -105,6 +119,227 @@ TEST(text_label, single) {
   TEST_ASSERT_EQUAL(2, text_measure_calls);
 }
 
+TEST(text_label, stats)
+{
+  register int i;
+  cig_stats_t stats[2];
+
+  for (i = 0; i < 2; ++i) {
+    begin();
+    cig_draw_label((cig_text_properties) { 0 }, "Olá mundo!");
+    stats[i] = *cig_stats();
+    end();
+  }
+
+  /*  First tick prepares the label, second one only renders it */
+  TEST_ASSERT_EQUAL_UINT(1, stats[0].text.label_cache_misses);
+  TEST_ASSERT_EQUAL_UINT(0, stats[0].text.label_cache_hits);
+  TEST_ASSERT_EQUAL_UINT(2, stats[0].text.measure_calls);
+  TEST_ASSERT_EQUAL_UINT(1, stats[0].text.render_calls);
+
+  TEST_ASSERT_EQUAL_UINT(0, stats[1].text.label_cache_misses);
+  TEST_ASSERT_EQUAL_UINT(1, stats[1].text.label_cache_hits);
+  TEST_ASSERT_EQUAL_UINT(0, stats[1].text.measure_calls);
+  TEST_ASSERT_EQUAL_UINT(1, stats[1].text.render_calls);
+
+  /*  Label memory is allocated once */
+  TEST_ASSERT_TRUE(stats[0].bytes.allocated > 0);
+  TEST_ASSERT_EQUAL_UINT(0, stats[1].bytes.allocated);
+}
+
+TEST(text_label, versioned)
+{
+  register int i;
+  char text[16] = "Hello";
+  const unsigned int versions[3] = { 1, 1, 2 };
+
+  for (i = 0; i < 3; ++i) {
+    begin();
+    if (i == 1) {
+      /*  Not picked up until the version changes */
+      strcpy(text, "Bye");
+    }
+    cig_label *label = cig_draw_label_versioned((cig_text_properties) { 0 }, versions[i], text);
+    TEST_ASSERT_EQUAL_UINT(i == 1 ? 1 : 0, cig_stats()->text.label_cache_hits);
+    TEST_ASSERT_EQUAL_INT(i < 2 ? 5 : 3, label->bounds.w);
+    end();
+  }
+}
+
+TEST(text_label, versioned_formatted)
+{
+  register int i;
+
+  for (i = 0; i < 2; ++i) {
+    begin();
+    if (cig_push_frame(cig_r_make(0, 0, 40, 1))) {
+      cig_draw_label_versioned((cig_text_properties) { .flags = CIG_TEXT_FORMATTED }, 0, "Count: %d", 10 + i);
+      cig_pop_frame();
+    }
+    /*  Overwrites the shared format buffer */
+    if (cig_push_frame(cig_r_make(0, 1, 40, 1))) {
+      cig_draw_label((cig_text_properties) { .flags = CIG_TEXT_FORMATTED }, "%s", "Something else");
+      cig_pop_frame();
+    }
+    end();
+
+    /*  Formatting is skipped on the second tick, the first value is kept */
+    TEST_ASSERT_EQUAL_STRING("Count: 10", spans.strings[0]);
+  }
+}
+
+TEST(text_label, versioned_formatted_size)
+{
+  register int i;
+  const int values[3] = { 7, 12345, 8 };
+  const size_t room[3] = { 2, 6, 6 };
+  const char *expected[3] = { "7", "12345", "8" };
+
+  /*  Copy is as long as the text, and only grows */
+  for (i = 0; i < 3; ++i) {
+    begin();
+    cig_label *label = cig_draw_label_versioned((cig_text_properties) { .flags = CIG_TEXT_FORMATTED }, i, "%d", values[i]);
+    TEST_ASSERT_EQUAL_UINT(room[i], label->available_text);
+    end();
+
+    TEST_ASSERT_EQUAL_STRING(expected[i], spans.strings[0]);
+  }
+}
+
+TEST(text_label, moved_text)
+{
+  register int i;
+  char first[8] = "Hello", second[8] = "Hello";
+
+  for (i = 0; i < 2; ++i) {
+    begin();
+    if (i == 1) {
+      strcpy(first, "Bye");
+    }
+    cig_draw_label((cig_text_properties) { 0 }, i == 0 ? first : second);
+    end();
+  }
+
+  /*  Second tick is served from cache, but drawn from the string passed in */
+  TEST_ASSERT_EQUAL_UINT(1, cig_stats()->text.label_cache_hits);
+  TEST_ASSERT_EQUAL_STRING("Hello", spans.strings[0]);
+}
+
+TEST(text_label, prepared_copy)
+{
+  begin();
+
+  cig_label *label = cig_memory_allocate(CIG_LABEL_SIZEOF_TEXT(2, 6));
+  label->available_spans = 2;
+  label->available_text = 6;
+
+  cig_label_prepare(label, cig_v_zero(), (cig_text_properties) { .flags = CIG_TEXT_FORMATTED | CIG_TEXT_COPY }, "%02d:%02d", 9, 5);
+
+  /*  Overwrites the shared format buffer before the prepared label is drawn */
+  if (cig_push_frame(cig_r_make(0, 1, 40, 1))) {
+    cig_draw_label((cig_text_properties) { .flags = CIG_TEXT_FORMATTED }, "%s", "Something else");
+    cig_pop_frame();
+  }
+
+  cig_label_draw(label);
+  TEST_ASSERT_EQUAL_STRING("09:05", spans.strings[1]);
+
+  /*  Text that doesn't fit is cut */
+  cig_label_prepare(label, cig_v_zero(), (cig_text_properties) { .flags = CIG_TEXT_COPY }, "Hello world");
+  cig_label_draw(label);
+  TEST_ASSERT_EQUAL_STRING("Hello", spans.strings[2]);
+
+  end();
+}
+
+TEST(text_label, growing_spans)
+{
+  register int i;
+  char text[128] = "";
+  cig_label *label;
+
+  /*  60 lines is more spans than a label used to have */
+  for (i = 0; i < 60; ++i) {
+    strcat(text, "a\n");
+  }
+
+  for (i = 0; i < 2; ++i) {
+    begin();
+    label = cig_draw_label((cig_text_properties) { 0 }, text);
+    if (i == 1) {
+      /*  Nothing is reallocated once the label fits */
+      TEST_ASSERT_EQUAL_UINT(0, cig_stats()->bytes.allocated);
+    }
+    end();
+  }
+
+  TEST_ASSERT_EQUAL_INT(60, label->span_count);
+  TEST_ASSERT_EQUAL_UINT(64, label->available_spans);
+
+  /*  Short label only has the initial spans */
+  begin();
+  if (cig_push_frame(cig_r_make(0, 0, 40, 1))) {
+    label = cig_draw_label((cig_text_properties) { 0 }, "Short");
+    TEST_ASSERT_EQUAL_UINT(CIG_LABEL_SPANS_INITIAL, label->available_spans);
+    cig_pop_frame();
+  }
+  end();
+}
+
+TEST(text_label, growing_spans_with_copy)
+{
+  begin();
+
+  /*  Text copy is moved after the grown spans */
+  cig_label *label = cig_draw_label_versioned((cig_text_properties) { .flags = CIG_TEXT_FORMATTED }, 0, "%s%s%s%s%s%s", "1\n", "2\n", "3\n", "4\n", "5\n", "6");
+  TEST_ASSERT_EQUAL_INT(6, label->span_count);
+  TEST_ASSERT_EQUAL_UINT(8, label->available_spans);
+  TEST_ASSERT_EQUAL_STRING("6", spans.strings[5]);
+
+  end();
+}
+
+/*  Arena that hands out memory once and never resizes it */
+static char arena[1 << 14];
+static size_t arena_used;
+
+static void* arena_alloc(void *ud, size_t size, size_t align) {
+  void *bytes = &arena[arena_used];
+  arena_used += (size + 15) & ~(size_t)15;
+  TEST_ASSERT_TRUE(arena_used <= sizeof(arena));
+  return bytes;
+}
+
+TEST(text_label, spans_without_realloc)
+{
+  register int i;
+  char text[256] = "";
+  cig_label *label;
+
+  arena_used = 0;
+  cig_set_allocator(&ctx, (cig_allocator) { .alloc = arena_alloc });
+
+  /*  Tags and lines that don't fit in the initial memory */
+  for (i = 0; i < 20; ++i) {
+    strcat(text, "<b>a</b> b\n");
+  }
+
+  for (i = 0; i < 3; ++i) {
+    begin();
+    CIG(cig_r_make(0, 0, 40 - i, 25)) {
+      label = cig_draw_label((cig_text_properties) { 0 }, text);
+    }
+    end();
+  }
+
+  /*  Label keeps its spans, and the tags are parsed as they come */
+  TEST_ASSERT_EQUAL_UINT(CIG_LABEL_SPANS_INITIAL, label->available_spans);
+  TEST_ASSERT_EQUAL_INT(CIG_LABEL_SPANS_INITIAL, label->span_count);
+  TEST_ASSERT_EQUAL_UINT(0, label->available_tags);
+  TEST_ASSERT_EQUAL_STRING("a", spans.strings[0]);
+  TEST_ASSERT_EQUAL_STRING(" b", spans.strings[1]);
+}
+
 TEST(text_label, single_trailing_newlines)
 {  
   begin();
@@ -494,6 +729,104 @@ TEST(text_label, multiline_overflow_ellipsis)
   end();
 }
 
+TEST(text_label, overflow_cuts_at_characters)
+{
+  begin();
+  CIG(RECT(0, 0, 8, 2)) {
+    cig_label *label = cig_draw_label((cig_text_properties) {
+      .alignment.horizontal = CIG_TEXT_ALIGN_LEFT,
+      .max_lines = 1,
+      .overflow = CIG_TEXT_SHOW_ELLIPSIS
+    }, "Öööbikutäätsakas");
+
+    /*  Cut after the 5th character, which isn't the 5th byte */
+    TEST_ASSERT_EQUAL_STRING("Öööbi", spans.strings[0]);
+    TEST_ASSERT_EQUAL_RECT(cig_r_make(0, 0, 5, 1), spans.rects[0]);
+    TEST_ASSERT_EQUAL_STRING("...", spans.strings[1]);
+    TEST_ASSERT_EQUAL_INT(1, label->line_count);
+  }
+  end();
+}
+
+TEST(text_label, overflow_measures_few_prefixes)
+{
+  begin();
+  CIG(RECT(0, 0, 20, 1)) {
+    cig_draw_label((cig_text_properties) {
+      .alignment.horizontal = CIG_TEXT_ALIGN_LEFT,
+      .max_lines = 1,
+      .overflow = CIG_TEXT_TRUNCATE
+    }, "C:\\Windows\\System32\\drivers\\etc\\a_rather_long_file_name.txt");
+
+    TEST_ASSERT_EQUAL_STRING("C:\\Windows\\System32\\", spans.strings[0]);
+
+    /*  Whole word and about one measure per halving of its 63 bytes */
+    TEST_ASSERT_TRUE(text_measure_calls <= 8);
+  }
+  end();
+}
+
+TEST(text_label, batched_rendering)
+{
+  const char *text = "Olá mundo!\nHello world!\n\nTere maailm!";
+  int i;
+
+  begin();
+  CIG(cig_r_make(0, 0, 15, 5)) {
+    cig_draw_label((cig_text_properties) { 0 }, text);
+  }
+  end();
+
+  /*  Same spans in one call, empty line doesn't draw anything */
+  cig_assign_draw_text_batch(&text_render_batch);
+  batch.count = batch.calls = 0;
+
+  begin();
+  CIG(cig_r_make(0, 0, 15, 5)) {
+    cig_draw_label((cig_text_properties) { 0 }, text);
+  }
+  end();
+
+  TEST_ASSERT_EQUAL_UINT(1, batch.calls);
+  TEST_ASSERT_EQUAL_UINT(3, batch.count);
+  TEST_ASSERT_EQUAL_UINT(0, spans.render_count);
+
+  for (i = 0; i < 3; ++i) {
+    TEST_ASSERT_EQUAL_RECT(spans.rects[i], batch.spans[i].rect);
+    TEST_ASSERT_EQUAL_STRING_LEN(spans.strings[i], batch.spans[i].str, batch.spans[i].len);
+  }
+}
+
+TEST(text_label, long_plain_runs)
+{
+  begin();
+
+  cig_label *label = cig_memory_allocate(CIG_LABEL_SIZEOF(8));
+  label->available_spans = 8;
+
+  /*  Runs longer than 16 bytes, with a tag, non-ASCII text and the end of
+      string inside them */
+  cig_label_prepare(
+    label,
+    cig_v_make(40, 4),
+    (cig_text_properties) { 0 },
+    "Abcdefghijklmnopqrstuvwxyz0123<b>Bold text</b>\nUnicode after 16 bytes: \xc3\xbc and more\nEnd of string after long run"
+  );
+
+  /*  Closing tag ends the span, the newline after it adds an empty one */
+  TEST_ASSERT_EQUAL(5, label->span_count);
+  TEST_ASSERT_EQUAL(30, label->spans[0].byte_len);
+  TEST_ASSERT_EQUAL(9, label->spans[1].byte_len);
+  TEST_ASSERT_EQUAL(CIG_TEXT_BOLD, label->spans[1].style_flags);
+  TEST_ASSERT_EQUAL(0, label->spans[2].byte_len);
+  TEST_ASSERT_EQUAL(35, label->spans[3].byte_len);
+  TEST_ASSERT_EQUAL_INT(34, label->spans[3].bounds.w);
+  TEST_ASSERT_EQUAL(28, label->spans[4].byte_len);
+  TEST_ASSERT_EQUAL(3, label->line_count);
+
+  end();
+}
+
 TEST(text_label, starts_with_empty_newline)
 {
   begin();
@@ -501,7 +834,7 @@ TEST(text_label, starts_with_empty_newline)
   cig_label *label = cig_draw_label((cig_text_properties) { }, "\nSecond line");
 
   TEST_ASSERT_EQUAL(1, spans.render_count);
-  TEST_ASSERT_NULL(label->spans[0].str);
+  TEST_ASSERT_EQUAL_UINT32(CIG_SPAN_NO_TEXT, label->spans[0].offset);
   TEST_ASSERT_EQUAL_STRING("Second line", spans.strings[0]);
   TEST_ASSERT_EQUAL_INT(2, label->span_count);
   TEST_ASSERT_EQUAL_INT(2, label->line_count);
@@ -536,9 +869,191 @@ TEST(text_label, raw_text_formatted)
   TEST_ASSERT_EQUAL_RECT(cig_r_make(5, 5, 22, 1), spans.rects[0]);
 }
 
+TEST(text_label, size_cache)
+{
+  begin();
+
+  /*  Repeated text is measured once per font and style */
+  cig_measure_raw_text(NULL, 0, "File");
+  cig_measure_raw_text(NULL, 0, "File");
+  cig_measure_raw_text(NULL, 0, "Edit");
+  TEST_ASSERT_EQUAL(2, text_measure_calls);
+
+  cig_measure_raw_text((cig_font_ref)1, 0, "File");
+  cig_measure_raw_text(NULL, CIG_TEXT_ITALIC, "File");
+  TEST_ASSERT_EQUAL(4, text_measure_calls);
+
+  TEST_ASSERT_EQUAL_UINT(1, cig_stats()->text.size_cache_hits);
+  TEST_ASSERT_EQUAL_UINT(4, cig_stats()->text.size_cache_misses);
+
+  /*  A new measure callback may measure differently */
+  cig_assign_measure_text(&text_measure);
+  cig_measure_raw_text(NULL, 0, "File");
+  TEST_ASSERT_EQUAL(5, text_measure_calls);
+
+  /*  Text with the same hash and length is still told apart */
+  cig_measure_raw_text(NULL, 0, "az");
+  cig_measure_raw_text(NULL, 0, "bY");
+  TEST_ASSERT_EQUAL(7, text_measure_calls);
+
+  end();
+}
+
+/*  Font whose glyphs can be measured one by one and added up */
+M_INLINED cig_font_info_st spaced_font_query(cig_font_ref font_ref) {
+  return (cig_font_info_st) {
+    .height = 1,
+    .cache_advances = true,
+    .letter_spacing = 1
+  };
+}
+
+TEST(text_label, glyph_cache)
+{
+  cig_assign_query_font(&spaced_font_query);
+  begin();
+
+  /*  Each distinct glyph is measured once, spacing goes between glyphs */
+  TEST_ASSERT_EQUAL_VEC2(cig_v_make(19, 1), cig_measure_raw_text(NULL, 0, "Olá mundo!"));
+  TEST_ASSERT_EQUAL(10, text_measure_calls);
+  TEST_ASSERT_EQUAL_UINT(10, cig_stats()->text.glyph_cache_misses);
+
+  TEST_ASSERT_EQUAL_VEC2(cig_v_make(9, 1), cig_measure_raw_text(NULL, 0, "mundo"));
+  TEST_ASSERT_EQUAL(10, text_measure_calls);
+  TEST_ASSERT_EQUAL_UINT(2, cig_stats()->text.glyph_cache_hits);
+
+  /*  Other styles have their own advances */
+  cig_measure_raw_text(NULL, CIG_TEXT_BOLD, "mundo");
+  TEST_ASSERT_EQUAL(15, text_measure_calls);
+
+  /*  Glyphs outside Latin-1 are left to the backend */
+  TEST_ASSERT_EQUAL_VEC2(cig_v_make(5, 1), cig_measure_raw_text(NULL, 0, "Ωmega"));
+  TEST_ASSERT_EQUAL(16, text_measure_calls);
+
+  /*  Clearing forgets the advances */
+  cig_clear_text_cache();
+  cig_measure_raw_text(NULL, 0, "mundo");
+  TEST_ASSERT_EQUAL(21, text_measure_calls);
+
+  end();
+}
+
+/*  Same text drawn into a narrower and narrower frame, as when a window is
+    resized, compared with a label prepared at the final width */
+static void resize_and_compare(const char *text, bool sums) {
+  const int widths[] = { 40, 30, 12 };
+  cig_label *label = NULL, *prepared;
+  int i, measure_calls = 0, word_sums = 0;
+
+  for (i = 0; i < 3; ++i) {
+    begin();
+    measure_calls = text_measure_calls;
+    CIG(cig_r_make(0, 0, widths[i], 10)) {
+      label = cig_draw_label((cig_text_properties) {
+        .alignment = { CIG_TEXT_ALIGN_LEFT, CIG_TEXT_ALIGN_TOP }
+      }, text);
+    }
+    measure_calls = text_measure_calls - measure_calls;
+    word_sums = cig_stats()->text.word_sums;
+    end();
+  }
+
+  /*  Words are measured on the first resize, later ones only add them up */
+  if (sums) {
+    TEST_ASSERT_EQUAL_INT(0, measure_calls);
+    TEST_ASSERT_TRUE(word_sums > 0);
+  } else {
+    TEST_ASSERT_EQUAL_INT(0, word_sums);
+  }
+
+  begin();
+  prepared = cig_memory_allocate(CIG_LABEL_SIZEOF(16));
+  prepared->available_spans = 16;
+  cig_label_prepare(prepared, cig_v_make(12, 10), (cig_text_properties) {
+    .alignment = { CIG_TEXT_ALIGN_LEFT, CIG_TEXT_ALIGN_TOP }
+  }, text);
+
+  TEST_ASSERT_EQUAL_INT(prepared->span_count, label->span_count);
+  TEST_ASSERT_EQUAL_INT(prepared->line_count, label->line_count);
+  TEST_ASSERT_EQUAL_INT(prepared->bounds.w, label->bounds.w);
+
+  for (i = 0; i < label->span_count; ++i) {
+    TEST_ASSERT_EQUAL_UINT(prepared->spans[i].offset, label->spans[i].offset);
+    TEST_ASSERT_EQUAL_UINT(prepared->spans[i].byte_len, label->spans[i].byte_len);
+    TEST_ASSERT_EQUAL_INT(prepared->spans[i].bounds.w, label->spans[i].bounds.w);
+    TEST_ASSERT_EQUAL_INT(prepared->spans[i].bounds.h, label->spans[i].bounds.h);
+    TEST_ASSERT_EQUAL_INT(prepared->spans[i].newlines, label->spans[i].newlines);
+  }
+  end();
+}
+
+/*  Font without kerning or letter spacing */
+M_INLINED cig_font_info_st fixed_font_query(cig_font_ref font_ref) {
+  return (cig_font_info_st) {
+    .height = 1,
+    .cache_advances = true
+  };
+}
+
+/*  Default font adds up, font 1 doesn't */
+M_INLINED cig_font_info_st tag_font_query(cig_font_ref font_ref) {
+  return (cig_font_info_st) {
+    .height = 1,
+    .cache_advances = !font_ref
+  };
+}
+
+/*  Advances of 1.5, with the width of text rounded down, so it's less than
+    the sum of its words */
+M_INLINED cig_v rounded_text_measure(
+  const char *str,
+  size_t len,
+  cig_font_ref font,
+  cig_text_style style
+) {
+  text_measure_calls ++;
+  return cig_v_make(utf8_char_count((utf8_string) { str, len }) * 3 / 2, 1);
+}
+
+TEST(text_label, resize)
+{
+  cig_assign_query_font(&fixed_font_query);
+  resize_and_compare("Lorem ipsum dolor  sit amet, <b>consectetur</b> adipiscing\nelit ", true);
+}
+
+TEST(text_label, resize_with_letter_spacing)
+{
+  cig_assign_query_font(&spaced_font_query);
+  resize_and_compare("Olá mundo! <i>Tere</i> maailm, hello  world ", true);
+}
+
+TEST(text_label, resize_without_cached_advances)
+{
+  /*  Words don't add up to the width of the text, so it's measured */
+  cig_assign_measure_text(&rounded_text_measure);
+  resize_and_compare("abc abc abc abc abc abc abc abc abc abc abc abc", false);
+}
+
+TEST(text_label, resize_with_uncached_tag_font)
+{
+  /*  Tags can switch to a font whose words don't add up either */
+  cig_assign_measure_text(&rounded_text_measure);
+  cig_assign_query_font(&tag_font_query);
+  resize_and_compare("abc abc <font=1>abc abc abc abc abc abc abc</font> abc abc abc", false);
+}
+
 TEST_GROUP_RUNNER(text_label)
 {
   RUN_TEST_CASE(text_label, single);
+  RUN_TEST_CASE(text_label, stats);
+  RUN_TEST_CASE(text_label, versioned);
+  RUN_TEST_CASE(text_label, versioned_formatted);
+  RUN_TEST_CASE(text_label, versioned_formatted_size);
+  RUN_TEST_CASE(text_label, moved_text);
+  RUN_TEST_CASE(text_label, prepared_copy);
+  RUN_TEST_CASE(text_label, growing_spans);
+  RUN_TEST_CASE(text_label, growing_spans_with_copy);
+  RUN_TEST_CASE(text_label, spans_without_realloc);
   RUN_TEST_CASE(text_label, single_trailing_newlines);
   RUN_TEST_CASE(text_label, multiline);
   RUN_TEST_CASE(text_label, span_limit);
@@ -560,7 +1075,17 @@ TEST_GROUP_RUNNER(text_label)
   RUN_TEST_CASE(text_label, single_line_overflow_ellipsis_ignores_newlines);
   RUN_TEST_CASE(text_label, multiline_overflow_truncate);
   RUN_TEST_CASE(text_label, multiline_overflow_ellipsis);
+  RUN_TEST_CASE(text_label, overflow_cuts_at_characters);
+  RUN_TEST_CASE(text_label, overflow_measures_few_prefixes);
+  RUN_TEST_CASE(text_label, batched_rendering);
+  RUN_TEST_CASE(text_label, long_plain_runs);
   RUN_TEST_CASE(text_label, starts_with_empty_newline);
   RUN_TEST_CASE(text_label, raw_text);
   RUN_TEST_CASE(text_label, raw_text_formatted);
+  RUN_TEST_CASE(text_label, size_cache);
+  RUN_TEST_CASE(text_label, glyph_cache);
+  RUN_TEST_CASE(text_label, resize);
+  RUN_TEST_CASE(text_label, resize_with_letter_spacing);
+  RUN_TEST_CASE(text_label, resize_without_cached_advances);
+  RUN_TEST_CASE(text_label, resize_with_uncached_tag_font);
 }
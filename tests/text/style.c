@@ -178,6 +178,77 @@ TEST(text_style, unknown_tag) {
   TEST_ASSERT_EQUAL_STRING("Rain+sun", spans.info[0].str);
 }
 
+TEST(text_style, tag_names_ignore_case) {
+  begin();
+
+  cig_draw_label((cig_text_properties) { 0 }, "<B>Bold</b> <DEL>Gone</Del>");
+
+  TEST_ASSERT_EQUAL(CIG_TEXT_BOLD, spans.info[0].style);
+  TEST_ASSERT_EQUAL_STRING("Gone", spans.info[2].str);
+  TEST_ASSERT_EQUAL(CIG_TEXT_STRIKETHROUGH, spans.info[2].style);
+}
+
+TEST(text_style, rewrap_keeps_tags) {
+  const char *text = "<b>bold words here</b>\n<i>italic words there</i>";
+  const char *expected[] = { "bold words", "here", "italic", "words", "there" };
+  cig_label *label;
+  cig_id markup_hash;
+  int k;
+
+  begin();
+  CIG(cig_r_make(0, 0, 40, 8)) {
+    label = cig_draw_label((cig_text_properties) {
+      .alignment = { CIG_TEXT_ALIGN_LEFT, CIG_TEXT_ALIGN_TOP }
+    }, text);
+  }
+  cig_end_layout();
+
+  TEST_ASSERT_EQUAL_UINT(4, label->tag_count);
+  TEST_ASSERT_EQUAL(2, label->line_count);
+  markup_hash = label->markup_hash;
+
+  /*  Same text at a new width is wrapped again from the same tags */
+  spans.count = 0;
+  begin();
+  CIG(cig_r_make(0, 0, 10, 8)) {
+    label = cig_draw_label((cig_text_properties) {
+      .alignment = { CIG_TEXT_ALIGN_LEFT, CIG_TEXT_ALIGN_TOP }
+    }, text);
+  }
+  cig_end_layout();
+
+  /*  ╔══════════╗
+      ║bold words║
+      ║here______║
+      ║italic____║
+      ║words_____║
+      ║there_____║
+      ╚══════════╝ */
+  TEST_ASSERT_EQUAL(markup_hash, label->markup_hash);
+  TEST_ASSERT_EQUAL(5, label->line_count);
+  TEST_ASSERT_EQUAL_UINT(5, spans.count);
+
+  for (k = 0; k < 5; ++k) {
+    TEST_ASSERT_EQUAL_STRING(expected[k], spans.info[k].str);
+    TEST_ASSERT_EQUAL_RECT(cig_r_make(0, k, strlen(expected[k]), 1), spans.info[k].rect);
+    TEST_ASSERT_EQUAL(k < 2 ? CIG_TEXT_BOLD : CIG_TEXT_ITALIC, spans.info[k].style);
+  }
+}
+
+TEST(text_style, wrap_before_tag) {
+  begin();
+
+  /*  Line breaks at the space, the word before the tag starts the next line */
+  CIG(cig_r_make(0, 0, 8, 5)) {
+    cig_draw_label((cig_text_properties) { 0 }, "aaaa bbbbbbb<b>c</b>");
+  }
+
+  TEST_ASSERT_EQUAL_STRING("aaaa", spans.info[0].str);
+  TEST_ASSERT_EQUAL_STRING("bbbbbbb", spans.info[1].str);
+  TEST_ASSERT_EQUAL_STRING("c", spans.info[2].str);
+  TEST_ASSERT_EQUAL(CIG_TEXT_BOLD, spans.info[2].style);
+}
+
 TEST_GROUP_RUNNER(text_style) {
   RUN_TEST_CASE(text_style, font_override);
   RUN_TEST_CASE(text_style, color_override);
@@ -188,4 +259,7 @@ TEST_GROUP_RUNNER(text_style) {
   RUN_TEST_CASE(text_style, override_base_style);
   RUN_TEST_CASE(text_style, unclosed_tag);
   RUN_TEST_CASE(text_style, unknown_tag);
+  RUN_TEST_CASE(text_style, tag_names_ignore_case);
+  RUN_TEST_CASE(text_style, rewrap_keeps_tags);
+  RUN_TEST_CASE(text_style, wrap_before_tag);
 }
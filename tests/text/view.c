@@ -0,0 +1,313 @@
+#include "unity.h"
+#include "fixture.h"
+#include "cigtextview.h"
+#include "cigcorem.h"
+#include "asserts.h"
+#include "allocator.h"
+#include "utf8.h"
+#include <stdio.h>
+#include <string.h>
+
+TEST_GROUP(text_view);
+
+static cig_context ctx;
+static cig_text_view view;
+static piece_table_char table;
+
+static struct {
+  char strings[32][64];
+  int y[32];
+  size_t count,
+         bytes;
+} spans;
+
+M_INLINED void text_render(
+  const char *str,
+  size_t len,
+  cig_r rect,
+  cig_font_ref font,
+  cig_text_color_ref color,
+  cig_text_style style
+) {
+  spans.bytes += len;
+  if (spans.count < 32) {
+    spans.y[spans.count] = rect.y;
+    snprintf(spans.strings[spans.count++], 64, "%.*s", (int)len, str);
+  }
+}
+
+M_INLINED cig_v text_measure(
+  const char *str,
+  size_t len,
+  cig_font_ref font,
+  cig_text_style style
+) {
+  utf8_string slice = (utf8_string) { str, len };
+  return cig_v_make(utf8_char_count(slice), 1);
+}
+
+M_INLINED cig_font_info_st font_query(cig_font_ref font_ref) {
+  return (cig_font_info_st) {
+    .height = 1,
+    .baseline_offset = 0
+  };
+}
+
+TEST_SETUP(text_view) {
+  cig_init_context(&ctx);
+
+  cig_assign_draw_text(&text_render);
+  cig_assign_measure_text(&text_measure);
+  cig_assign_query_font(&font_query);
+
+  set_up_test_allocator(&ctx);
+
+  spans.count = 0;
+}
+
+TEST_TEAR_DOWN(text_view) {
+  cig_text_view_free(&view);
+  /*  Edits may have moved the buffer */
+  gap_buffer_char_free(&view.buffer);
+  if (view.table) {
+    piece_table_char_free(view.table);
+  }
+}
+
+static void load(const char *text) {
+  const size_t length = strlen(text);
+  gap_buffer_char *buffer;
+
+  gap_buffer_char_new(&buffer, &ctx.allocator, 0, length + 16);
+  gap_buffer_char_insert(&buffer, 0, length, text);
+  cig_text_view_init(&view, buffer);
+}
+
+/*  Document of `count` lines "Line N" */
+static void load_lines(int count) {
+  gap_buffer_char *buffer;
+  char line[16];
+  int i;
+
+  gap_buffer_char_new(&buffer, &ctx.allocator, 0, count * 10);
+  for (i = 0; i < count; ++i) {
+    const int length = snprintf(line, sizeof(line), i + 1 < count ? "Line %d\n" : "Line %d", i);
+    gap_buffer_char_insert(&buffer, GAPTAIL, length, line);
+  }
+  cig_text_view_init(&view, buffer);
+}
+
+/*  20 x 5 character view in a 80 x 25 terminal */
+static void tick() {
+  spans.count = spans.bytes = 0;
+  cig_begin_layout(&ctx, NULL, cig_r_make(0, 0, 80, 25), 0.1f);
+  cig_draw_text_view(&view, cig_r_make(0, 0, 20, 5));
+  cig_end_layout();
+}
+
+/*  Sets the offset of the view's scroll state, pushing a frame with the same Id */
+static void scroll_to(int32_t y) {
+  cig_begin_layout(&ctx, NULL, cig_r_make(0, 0, 80, 25), 0.1f);
+  if (cig_push_frame(cig_r_make(0, 0, 20, 5))) {
+    cig_enable_scroll(NULL);
+    cig_set_offset(cig_v_make(0, y));
+    cig_pop_frame();
+  }
+  cig_end_layout();
+}
+
+static char* text(char out[]) {
+  size_t length;
+
+  if (view.table) {
+    length = piece_table_char_length(view.table);
+    piece_table_char_read(view.table, 0, length, out);
+  } else {
+    length = gap_buffer_char_length(view.buffer);
+    gap_buffer_char_read(view.buffer, 0, length, out);
+  }
+
+  out[length] = '\0';
+  return out;
+}
+
+/*  ┌────────────┐
+    │ TEST CASES │
+    └────────────┘ */
+
+TEST(text_view, paragraphs) {
+  load("One\nTwo\n\nThree\n");
+
+  /*  Trailing newline leaves an empty paragraph at the end */
+  TEST_ASSERT_EQUAL_UINT(5, cig_text_view_paragraph_count(&view));
+  TEST_ASSERT_EQUAL_UINT(4, gap_buffer_char_line_length(view.buffer, 0));
+  TEST_ASSERT_EQUAL_UINT(1, gap_buffer_char_line_length(view.buffer, 2));
+  TEST_ASSERT_EQUAL_UINT(0, gap_buffer_char_line_length(view.buffer, 4));
+  TEST_ASSERT_EQUAL_INT64(5, cig_text_view_content_height(&view, 1));
+}
+
+TEST(text_view, draws_visible_paragraphs) {
+  load_lines(1000);
+  tick();
+
+  TEST_ASSERT_EQUAL_UINT(5, cig_stats()->text.label_cache_misses);
+  TEST_ASSERT_EQUAL_UINT(5, spans.count);
+  TEST_ASSERT_EQUAL_STRING("Line 0", spans.strings[0]);
+  TEST_ASSERT_EQUAL_STRING("Line 4", spans.strings[4]);
+  TEST_ASSERT_EQUAL_INT(4, spans.y[4]);
+
+  /*  Nothing changed */
+  tick();
+
+  TEST_ASSERT_EQUAL_UINT(0, cig_stats()->text.label_cache_misses);
+  TEST_ASSERT_EQUAL_UINT(5, cig_stats()->text.label_cache_hits);
+}
+
+TEST(text_view, wraps_paragraphs) {
+  load("This paragraph is long enough to wrap\nNext");
+  tick();
+
+  TEST_ASSERT_EQUAL_STRING("This paragraph is", spans.strings[0]);
+  TEST_ASSERT_EQUAL_STRING("long enough to wrap", spans.strings[1]);
+  TEST_ASSERT_EQUAL_STRING("Next", spans.strings[2]);
+  TEST_ASSERT_EQUAL_INT(2, spans.y[2]);
+  TEST_ASSERT_EQUAL_INT64(3, cig_text_view_content_height(&view, 1));
+}
+
+TEST(text_view, long_paragraph) {
+  static char line[70001];
+
+  /*  Longer than 16 bits, without a place to wrap */
+  memset(line, 'x', 70000);
+  line[70000] = '\0';
+  load(line);
+  tick();
+
+  TEST_ASSERT_EQUAL_UINT(70000, spans.bytes);
+}
+
+TEST(text_view, edit_relayouts_paragraph) {
+  static char out[16384];
+
+  load_lines(1000);
+  tick();
+
+  cig_text_view_insert(&view, 12, 3, "abc");
+  tick();
+
+  /*  Only the edited paragraph is laid out again */
+  TEST_ASSERT_EQUAL_UINT(1, cig_stats()->text.label_cache_misses);
+  TEST_ASSERT_EQUAL_UINT(4, cig_stats()->text.label_cache_hits);
+  TEST_ASSERT_EQUAL_STRING("Line abc1", spans.strings[1]);
+
+  cig_text_view_delete(&view, 12, 3);
+  cig_text_view_replace(&view, 0, 4, 3, "Row");
+  tick();
+
+  TEST_ASSERT_EQUAL_UINT(2, cig_stats()->text.label_cache_misses);
+  TEST_ASSERT_EQUAL_STRING("Row 0", spans.strings[0]);
+  TEST_ASSERT_EQUAL_STRING("Line 1", spans.strings[1]);
+  TEST_ASSERT_EQUAL_STRING_LEN("Row 0\nLine 1\n", text(out), 13);
+}
+
+TEST(text_view, split_and_merge) {
+  char out[64];
+
+  load("Alpha\nBeta\nGamma");
+  tick();
+
+  /*  Newlines split the paragraph they are inserted to */
+  cig_text_view_insert(&view, 2, 4, "\nX\nY");
+  TEST_ASSERT_EQUAL_UINT(5, cig_text_view_paragraph_count(&view));
+  TEST_ASSERT_EQUAL_STRING("Al\nX\nYpha\nBeta\nGamma", text(out));
+
+  tick();
+  TEST_ASSERT_EQUAL_STRING("Al", spans.strings[0]);
+  TEST_ASSERT_EQUAL_STRING("X", spans.strings[1]);
+  TEST_ASSERT_EQUAL_STRING("Ypha", spans.strings[2]);
+  TEST_ASSERT_EQUAL_STRING("Gamma", spans.strings[4]);
+
+  /*  Deleting across newlines merges the paragraphs */
+  cig_text_view_delete(&view, 1, 10);
+  TEST_ASSERT_EQUAL_UINT(2, cig_text_view_paragraph_count(&view));
+  TEST_ASSERT_EQUAL_STRING("Aeta\nGamma", text(out));
+
+  tick();
+  TEST_ASSERT_EQUAL_UINT(2, spans.count);
+  TEST_ASSERT_EQUAL_STRING("Aeta", spans.strings[0]);
+  TEST_ASSERT_EQUAL_INT64(2, cig_text_view_content_height(&view, 1));
+}
+
+TEST(text_view, scrolling) {
+  load_lines(1000);
+  tick();
+
+  /*  Paragraphs that haven't been drawn count as one line */
+  TEST_ASSERT_EQUAL_INT64(1000, cig_text_view_content_height(&view, 1));
+
+  /*  Jump near the end */
+  cig_text_view_scroll_to_line(&view, 990);
+  tick();
+
+  TEST_ASSERT_EQUAL_UINT(5, spans.count);
+  TEST_ASSERT_EQUAL_STRING("Line 990", spans.strings[0]);
+  TEST_ASSERT_EQUAL_INT(0, spans.y[0]);
+
+  /*  Paragraph wraps to three lines */
+  cig_text_view_insert(&view, 8805, 34, "which now wraps to three lines and");
+  tick();
+
+  TEST_ASSERT_EQUAL_STRING("Line 991", spans.strings[3]);
+  TEST_ASSERT_EQUAL_INT64(1002, cig_text_view_content_height(&view, 1));
+
+  /*  Paragraph starting above the viewport gets shorter, the offset follows
+      it so the text below stays in place */
+  scroll_to(991);
+  tick();
+  TEST_ASSERT_EQUAL_STRING("Line 991", spans.strings[3]);
+  TEST_ASSERT_EQUAL_INT(2, spans.y[3]);
+
+  cig_text_view_delete(&view, 8805, 34);
+  tick();
+  tick();
+
+  TEST_ASSERT_EQUAL_STRING("Line 991", spans.strings[2]);
+  TEST_ASSERT_EQUAL_INT(2, spans.y[2]);
+  TEST_ASSERT_EQUAL_INT64(1000, cig_text_view_content_height(&view, 1));
+}
+
+TEST(text_view, piece_table) {
+  char out[64];
+
+  piece_table_char_init(&table, &ctx.allocator, "Alpha\nBeta\nGamma", 16);
+  cig_text_view_init_piece_table(&view, &table);
+  tick();
+
+  TEST_ASSERT_EQUAL_UINT(3, spans.count);
+  TEST_ASSERT_EQUAL_STRING("Beta", spans.strings[1]);
+
+  /*  Paragraph text spans the original and the added text */
+  cig_text_view_insert(&view, 8, 4, "\nX\nY");
+  cig_text_view_delete(&view, 0, 2);
+  TEST_ASSERT_EQUAL_UINT(5, cig_text_view_paragraph_count(&view));
+  TEST_ASSERT_EQUAL_STRING("pha\nBe\nX\nYta\nGamma", text(out));
+
+  /*  Only the last paragraph is unchanged */
+  tick();
+  TEST_ASSERT_EQUAL_UINT(4, cig_stats()->text.label_cache_misses);
+  TEST_ASSERT_EQUAL_STRING("pha", spans.strings[0]);
+  TEST_ASSERT_EQUAL_STRING("Be", spans.strings[1]);
+  TEST_ASSERT_EQUAL_STRING("Yta", spans.strings[3]);
+  TEST_ASSERT_EQUAL_STRING("Gamma", spans.strings[4]);
+}
+
+TEST_GROUP_RUNNER(text_view) {
+  RUN_TEST_CASE(text_view, paragraphs);
+  RUN_TEST_CASE(text_view, draws_visible_paragraphs);
+  RUN_TEST_CASE(text_view, wraps_paragraphs);
+  RUN_TEST_CASE(text_view, long_paragraph);
+  RUN_TEST_CASE(text_view, edit_relayouts_paragraph);
+  RUN_TEST_CASE(text_view, split_and_merge);
+  RUN_TEST_CASE(text_view, scrolling);
+  RUN_TEST_CASE(text_view, piece_table);
+}
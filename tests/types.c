@@ -3,6 +3,8 @@
 #include "cig.h"
 #include "asserts.h"
 #include "types/gap_buffer.h"
+#include "types/piece_table.h"
+#include <stdio.h>
 
 /* Declare a stack type */
 #define STACK_CAPACITY_int 8
@@ -90,6 +92,50 @@ TEST(types, rect_union) {
   );
 }
 
+/*  Small deterministic generator so failures are reproducible */
+static uint32_t rect_rng_state = 1;
+
+static int32_t rect_rng(int32_t min, int32_t max) {
+  rect_rng_state = rect_rng_state * 1103515245u + 12345u;
+  return min + (int32_t)((rect_rng_state >> 8) % (uint32_t)(max - min + 1));
+}
+
+static cig_r random_rect() {
+  return cig_r_make(rect_rng(-200, 200), rect_rng(-200, 200), rect_rng(0, 150), rect_rng(0, 150));
+}
+
+TEST(types, rect_simd_matches_scalar) {
+  int i, j;
+  cig_r rects[7];
+  bool hits[7];
+
+  for (i = 0; i < 20000; ++i) {
+    const cig_r a = random_rect();
+    const cig_r b = random_rect();
+    const cig_v p = cig_v_make(rect_rng(-200, 350), rect_rng(-200, 350));
+
+    TEST_ASSERT_EQUAL(cig_r_intersects(a, b), cig_r_intersects_simd(a, b));
+    TEST_ASSERT_EQUAL_RECT(cig_r_union(a, b), cig_r_union_simd(a, b));
+    TEST_ASSERT_EQUAL_RECT(cig_r_containing(a, b), cig_r_containing_simd(a, b));
+    TEST_ASSERT_EQUAL(cig_r_contains(a, p), cig_r_contains_simd(a, p));
+  }
+
+  /*  Batch form, including a remainder that doesn't fill a whole group of 4 */
+  for (i = 0; i < 5000; ++i) {
+    const cig_r b = random_rect();
+
+    for (j = 0; j < 7; ++j) {
+      rects[j] = random_rect();
+    }
+
+    cig_r_intersects_n(b, rects, 7, hits);
+
+    for (j = 0; j < 7; ++j) {
+      TEST_ASSERT_EQUAL(cig_r_intersects(rects[j], b), hits[j]);
+    }
+  }
+}
+
 TEST(types, insets_constructors) {
   const cig_i i0 = cig_i_zero();
   const cig_i i1 = cig_i_make(10, 20, 30, 40);
@@ -155,7 +201,7 @@ TEST(types, gap_buffer)
   gap_buffer_char *gap_buffer;
 
   /* Start with an empty buffer. Gap is at the beginning */
-  gap_buffer_char_new(&gap_buffer, 0, 16);                            /* [^_______________] */
+  gap_buffer_char_new(&gap_buffer, NULL, 0, 16);                      /* [^_______________] */
   TEST_ASSERT_EQUAL_INT(16, gap_buffer->size);
   TEST_ASSERT_EQUAL_INT(0, gap_buffer->gap.start);
   TEST_ASSERT_EQUAL_INT(16, gap_buffer->gap.size);
@@ -192,6 +238,301 @@ TEST(types, gap_buffer)
   TEST_ASSERT_NULL(gap_buffer);
 }
 
+static int gap_buffer_allocs;
+
+static void* gap_buffer_alloc(void *ud, size_t size, size_t align) {
+  gap_buffer_allocs++;
+  return malloc(size);
+}
+
+static void* gap_buffer_realloc(void *ud, void *ptr, size_t old_size, size_t new_size) {
+  gap_buffer_allocs++;
+  return realloc(ptr, new_size);
+}
+
+static void gap_buffer_release(void *ud, void *ptr) {
+  free(ptr);
+}
+
+TEST(types, gap_buffer_growth)
+{
+  gap_buffer_char *gap_buffer;
+  cig_allocator allocator = { gap_buffer_alloc, gap_buffer_realloc, gap_buffer_release };
+  char text[100], out[100];
+
+  memset(text, 'a', sizeof(text));
+  gap_buffer_allocs = 0;
+
+  gap_buffer_char_new(&gap_buffer, &allocator, 0, 16);
+  gap_buffer_char_insert(&gap_buffer, GAPTAIL, 10, text);
+  TEST_ASSERT_EQUAL_UINT(sizeof(gap_buffer_char) + 16, allocator.tracked_bytes);
+
+  /* Insert of several times the size doubles the buffer until it fits */
+  gap_buffer_char_insert(&gap_buffer, 5, 100, text);
+  TEST_ASSERT_EQUAL_UINT(128, gap_buffer->size);
+  TEST_ASSERT_EQUAL_UINT(110, gap_buffer_char_length(gap_buffer));
+  TEST_ASSERT_EQUAL_UINT(sizeof(gap_buffer_char) + 128, allocator.tracked_bytes);
+  TEST_ASSERT_EQUAL_INT(2, gap_buffer_allocs);
+
+  gap_buffer_char_read(gap_buffer, 10, 100, out);
+  TEST_ASSERT_EQUAL_MEMORY(text, out, 100);
+
+  /* Reserve grows exactly as much as needed, once */
+  gap_buffer_char_reserve(&gap_buffer, 1000);
+  TEST_ASSERT_EQUAL_UINT(1110, gap_buffer->size);
+  gap_buffer_char_reserve(&gap_buffer, 500);
+  TEST_ASSERT_EQUAL_INT(3, gap_buffer_allocs);
+
+  gap_buffer_char_free(&gap_buffer);
+  TEST_ASSERT_EQUAL_UINT(0, allocator.tracked_bytes);
+}
+
+TEST(types, fenwick_tree)
+{
+  fenwick_tree f;
+  size_t i;
+
+  fenwick_tree_init(&f);
+  for (i = 0; i < 5; ++i) {
+    fenwick_tree_push(&f, i + 1);                                       /* [1 2 3 4 5] */
+  }
+  fenwick_tree_rebuild(&f);
+
+  TEST_ASSERT_EQUAL_INT64(0, fenwick_tree_prefix(&f, 0));
+  TEST_ASSERT_EQUAL_INT64(6, fenwick_tree_prefix(&f, 3));
+  TEST_ASSERT_EQUAL_INT64(15, fenwick_tree_prefix(&f, 5));
+
+  /* Element a running total falls in */
+  TEST_ASSERT_EQUAL_UINT(0, fenwick_tree_find(&f, 0));
+  TEST_ASSERT_EQUAL_UINT(2, fenwick_tree_find(&f, 3));
+  TEST_ASSERT_EQUAL_UINT(2, fenwick_tree_find(&f, 5));
+  TEST_ASSERT_EQUAL_UINT(5, fenwick_tree_find(&f, 15));
+
+  fenwick_tree_add(&f, 1, 10);                                          /* [1 12 3 4 5] */
+  TEST_ASSERT_EQUAL_INT64(16, fenwick_tree_prefix(&f, 3));
+
+  fenwick_tree_insert(&f, 1, 2);                                        /* [1 0 0 12 3 4 5] */
+  fenwick_tree_set(&f, 2, 7);                                           /* [1 0 7 12 3 4 5] */
+  TEST_ASSERT_EQUAL_INT64(20, fenwick_tree_prefix(&f, 4));
+  TEST_ASSERT_EQUAL_UINT(2, fenwick_tree_find(&f, 1));
+
+  fenwick_tree_remove(&f, 0, 3);                                        /* [12 3 4 5] */
+  TEST_ASSERT_EQUAL_UINT(4, f.count);
+  TEST_ASSERT_EQUAL_INT64(24, fenwick_tree_prefix(&f, 4));
+
+  fenwick_tree_free(&f);
+}
+
+TEST(types, fenwick_tree_blocks)
+{
+  fenwick_tree f;
+  int64_t values[2000];
+  size_t items[2000], count = 1000, i, blocks;
+  int64_t sum = 0;
+
+  /* Items are the values' original indices */
+  fenwick_tree_init(&f);
+  f.item_size = sizeof(size_t);
+  for (i = 0; i < count; ++i) {
+    *(size_t*)fenwick_tree_push(&f, values[i] = i % 7) = items[i] = i;
+  }
+  fenwick_tree_rebuild(&f);
+  TEST_ASSERT_EQUAL_UINT(4, f.block_count);
+
+  /* Inserting into a full block splits it */
+  fenwick_tree_insert(&f, 300, 1);
+  fenwick_tree_set(&f, 300, 100);
+  *(size_t*)fenwick_tree_item(&f, 300) = 5000;
+  memmove(&values[301], &values[300], sizeof(int64_t) * (count - 300));
+  memmove(&items[301], &items[300], sizeof(size_t) * (count - 300));
+  values[300] = 100;
+  items[300] = 5000;
+  count += 1;
+  TEST_ASSERT_EQUAL_UINT(5, f.block_count);
+
+  /* More than a block's worth of values goes into new blocks */
+  fenwick_tree_insert(&f, 700, 600);
+  memmove(&values[1300], &values[700], sizeof(int64_t) * (count - 700));
+  memmove(&items[1300], &items[700], sizeof(size_t) * (count - 700));
+  memset(&values[700], 0, sizeof(int64_t) * 600);
+  memset(&items[700], 0, sizeof(size_t) * 600);
+  count += 600;
+
+  /* Removing across blocks drops the emptied ones and joins the rest */
+  blocks = f.block_count;
+  fenwick_tree_remove(&f, 200, 900);
+  memmove(&values[200], &values[1100], sizeof(int64_t) * (count - 1100));
+  memmove(&items[200], &items[1100], sizeof(size_t) * (count - 1100));
+  count -= 900;
+  TEST_ASSERT_EQUAL_UINT(count, f.count);
+  TEST_ASSERT_LESS_THAN_UINT(blocks, f.block_count);
+
+  for (i = 0; i < count; ++i) {
+    TEST_ASSERT_EQUAL_INT64(values[i], fenwick_tree_get(&f, i));
+    TEST_ASSERT_EQUAL_UINT(items[i], *(size_t*)fenwick_tree_item(&f, i));
+    TEST_ASSERT_EQUAL_INT64(sum, fenwick_tree_prefix(&f, i));
+    if (values[i]) {
+      TEST_ASSERT_EQUAL_UINT(i, fenwick_tree_find(&f, sum));
+    }
+    sum += values[i];
+  }
+  TEST_ASSERT_EQUAL_INT64(sum, fenwick_tree_prefix(&f, count));
+  TEST_ASSERT_EQUAL_UINT(count, fenwick_tree_find(&f, sum));
+
+  fenwick_tree_free(&f);
+}
+
+/* Fails once `*ud` allocations have been made */
+static void* limited_alloc(void *ud, size_t size, size_t align) {
+  return (*(int*)ud)-- > 0 ? malloc(size) : NULL;
+}
+
+TEST(types, fenwick_tree_out_of_memory)
+{
+  fenwick_tree f;
+  int left = 100;
+  cig_allocator allocator = { limited_alloc, NULL, gap_buffer_release, &left };
+  size_t i, tracked;
+
+  fenwick_tree_init(&f);
+  f.allocator = &allocator;
+  for (i = 0; i < FENWICK_TREE_BLOCK; ++i) {
+    TEST_ASSERT_NOT_NULL(fenwick_tree_push(&f, 1));
+  }
+  fenwick_tree_rebuild(&f);
+  tracked = allocator.tracked_bytes;
+
+  /* Splitting the full block needs two new ones, neither of which is kept */
+  left = 1;
+  TEST_ASSERT_FALSE(fenwick_tree_insert(&f, 10, 1));
+  left = 0;
+  TEST_ASSERT_NULL(fenwick_tree_push(&f, 1));
+  TEST_ASSERT_EQUAL_UINT(tracked, allocator.tracked_bytes);
+  TEST_ASSERT_EQUAL_UINT(FENWICK_TREE_BLOCK, f.count);
+  TEST_ASSERT_EQUAL_UINT(1, f.block_count);
+  TEST_ASSERT_EQUAL_INT64(FENWICK_TREE_BLOCK, fenwick_tree_prefix(&f, f.count));
+
+  left = 100;
+  TEST_ASSERT_TRUE(fenwick_tree_insert(&f, 10, 1));
+  TEST_ASSERT_EQUAL_INT64(0, fenwick_tree_get(&f, 10));
+  TEST_ASSERT_EQUAL_INT64(FENWICK_TREE_BLOCK, fenwick_tree_prefix(&f, f.count));
+
+  fenwick_tree_free(&f);
+  TEST_ASSERT_EQUAL_UINT(0, allocator.tracked_bytes);
+}
+
+TEST(types, gap_buffer_lines)
+{
+  gap_buffer_char *gap_buffer;
+  fenwick_tree lines;
+
+  fenwick_tree_init(&lines);
+  gap_buffer_char_new(&gap_buffer, NULL, 0, 8);
+  gap_buffer_char_insert(&gap_buffer, 0, 8, "One\nTwo\n");
+  gap_buffer_char_index_lines(gap_buffer, &lines);                      /* [One\n|Two\n|] */
+
+  TEST_ASSERT_EQUAL_UINT(3, gap_buffer_char_line_count(gap_buffer));
+  TEST_ASSERT_EQUAL_UINT(0, gap_buffer_char_line_length(gap_buffer, 2));
+  TEST_ASSERT_EQUAL_UINT(1, gap_buffer_char_line_at(gap_buffer, 4));
+  TEST_ASSERT_EQUAL_UINT(2, gap_buffer_char_line_at(gap_buffer, 8));
+  TEST_ASSERT_EQUAL_UINT(4, gap_buffer_char_line_start(gap_buffer, 1));
+
+  /* Newlines split the line they're inserted to */
+  gap_buffer_char_insert(&gap_buffer, 5, 4, "X\nY\n");                  /* [One\n|TX\n|Y\n|wo\n|] */
+  TEST_ASSERT_EQUAL_UINT(5, gap_buffer_char_line_count(gap_buffer));
+  TEST_ASSERT_EQUAL_UINT(3, gap_buffer_char_line_length(gap_buffer, 1));
+  TEST_ASSERT_EQUAL_UINT(2, gap_buffer_char_line_length(gap_buffer, 2));
+  TEST_ASSERT_EQUAL_UINT(3, gap_buffer_char_line_length(gap_buffer, 3));
+  TEST_ASSERT_EQUAL_UINT(3, gap_buffer_char_line_at(gap_buffer, 9));
+
+  /* Text without newlines only changes the length */
+  gap_buffer_char_insert(&gap_buffer, GAPTAIL, 3, "End");               /* [One\n|TX\n|Y\n|wo\n|End] */
+  TEST_ASSERT_EQUAL_UINT(3, gap_buffer_char_line_length(gap_buffer, 4));
+
+  /* Deleting across newlines joins the lines */
+  gap_buffer_char_delete(&gap_buffer, 2, 8);                            /* [Ono\n|End] */
+  TEST_ASSERT_EQUAL_UINT(2, gap_buffer_char_line_count(gap_buffer));
+  TEST_ASSERT_EQUAL_UINT(4, gap_buffer_char_line_length(gap_buffer, 0));
+  TEST_ASSERT_EQUAL_UINT(1, gap_buffer_char_line_at(gap_buffer, 4));
+
+  gap_buffer_char_replace(&gap_buffer, 0, 4, 2, "A\n");                 /* [A\n|End] */
+  TEST_ASSERT_EQUAL_UINT(2, gap_buffer_char_line_count(gap_buffer));
+  TEST_ASSERT_EQUAL_UINT(2, gap_buffer_char_line_length(gap_buffer, 0));
+  TEST_ASSERT_EQUAL_UINT(2, gap_buffer_char_line_start(gap_buffer, 1));
+
+  gap_buffer_char_free(&gap_buffer);
+  fenwick_tree_free(&lines);
+}
+
+TEST(types, piece_table)
+{
+  piece_table_char table;
+  piece_table_char_iterator iter;
+  fenwick_tree lines;
+  const char *str;
+  char out[32];
+  size_t length;
+
+  fenwick_tree_init(&lines);
+  piece_table_char_init(&table, NULL, "One\nTwo\n", 8);
+  piece_table_char_index_lines(&table, &lines);                          /* [One\n|Two\n|] */
+  TEST_ASSERT_EQUAL_UINT(3, lines.count);
+
+  /* Typing continues the same piece */
+  piece_table_char_insert(&table, 5, 1, "X");
+  piece_table_char_insert(&table, 6, 2, "\nY");                         /* [One\n|TX\n|Ywo\n|] */
+  TEST_ASSERT_EQUAL_UINT(3, table.piece_count);
+  TEST_ASSERT_EQUAL_UINT(11, piece_table_char_length(&table));
+  TEST_ASSERT_EQUAL_UINT(4, lines.count);
+  TEST_ASSERT_EQUAL_INT64(3, fenwick_tree_get(&lines, 1));
+
+  piece_table_char_read(&table, 0, 11, out);
+  TEST_ASSERT_EQUAL_STRING_LEN("One\nTX\nYwo\n", out, 11);
+
+  /* Iterator returns the pieces as they are, clipped to the range */
+  iter = piece_table_char_iterate(&table, 2, 6);
+  TEST_ASSERT_TRUE(piece_table_char_next(&iter, &str, &length));
+  TEST_ASSERT_EQUAL_STRING_LEN("e\nT", str, 3);
+  TEST_ASSERT_EQUAL_UINT(3, length);
+  TEST_ASSERT_TRUE(piece_table_char_next(&iter, &str, &length));
+  TEST_ASSERT_EQUAL_STRING_LEN("X\nY", str, 3);
+  TEST_ASSERT_EQUAL_UINT(3, length);
+  TEST_ASSERT_FALSE(piece_table_char_next(&iter, &str, &length));
+
+  /* Deleting across pieces joins the lines */
+  piece_table_char_delete(&table, 2, 7);                                 /* [Ono\n|] */
+  TEST_ASSERT_EQUAL_UINT(4, piece_table_char_length(&table));
+  TEST_ASSERT_EQUAL_UINT(2, lines.count);
+  TEST_ASSERT_EQUAL_INT64(4, fenwick_tree_get(&lines, 0));
+
+  piece_table_char_replace(&table, 0, 2, 3, "Two");                      /* [Twoo\n|] */
+  piece_table_char_read(&table, 0, piece_table_char_length(&table), out);
+  TEST_ASSERT_EQUAL_STRING_LEN("Twoo\n", out, 5);
+
+  piece_table_char_free(&table);
+  fenwick_tree_free(&lines);
+}
+
+TEST(types, piece_table_open)
+{
+  piece_table_char table;
+  FILE *file = fopen("piece_table_test.txt", "wb");
+  char out[16];
+
+  fputs("Mapped text", file);
+  fclose(file);
+
+  TEST_ASSERT_FALSE(piece_table_char_open(&table, NULL, "missing_piece_table_test.txt"));
+  TEST_ASSERT_TRUE(piece_table_char_open(&table, NULL, "piece_table_test.txt"));
+  remove("piece_table_test.txt");
+
+  piece_table_char_insert(&table, 0, 4, "Not ");
+  piece_table_char_read(&table, 0, 15, out);
+  TEST_ASSERT_EQUAL_STRING_LEN("Not Mapped text", out, 15);
+
+  piece_table_char_free(&table);
+}
+
 TEST_GROUP_RUNNER(types) {
   RUN_TEST_CASE(types, rect_constructors);
   RUN_TEST_CASE(types, rect_comparator);
@@ -202,6 +543,7 @@ TEST_GROUP_RUNNER(types) {
   RUN_TEST_CASE(types, rect_center);
   RUN_TEST_CASE(types, rect_containing);
   RUN_TEST_CASE(types, rect_union);
+  RUN_TEST_CASE(types, rect_simd_matches_scalar);
   RUN_TEST_CASE(types, insets_constructors);
   RUN_TEST_CASE(types, vec2_constructors);
   RUN_TEST_CASE(types, vec2_operations);
@@ -209,4 +551,11 @@ TEST_GROUP_RUNNER(types) {
   RUN_TEST_CASE(types, vec2_math);
   RUN_TEST_CASE(types, stack_operations);
   RUN_TEST_CASE(types, gap_buffer);
+  RUN_TEST_CASE(types, gap_buffer_growth);
+  RUN_TEST_CASE(types, fenwick_tree);
+  RUN_TEST_CASE(types, fenwick_tree_blocks);
+  RUN_TEST_CASE(types, fenwick_tree_out_of_memory);
+  RUN_TEST_CASE(types, gap_buffer_lines);
+  RUN_TEST_CASE(types, piece_table);
+  RUN_TEST_CASE(types, piece_table_open);
 }
@@ -0,0 +1,170 @@
+#include "cigsnapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*  Compares two layout snapshots record by record and prints where they
+    first diverge in each tick. Exits with 0 if the layouts are identical,
+    1 if they differ and 2 if either file can't be read.
+
+    Usage: snapshot_diff [-n max differences] a.cigs b.cigs */
+
+#define DEFAULT_MAX_DIFFERENCES 20
+
+static void* read_file(const char *path, size_t *size) {
+  FILE *file = fopen(path, "rb");
+  void *bytes;
+
+  if (!file) {
+    return NULL;
+  }
+
+  fseek(file, 0, SEEK_END);
+  *size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  bytes = malloc(*size);
+  if (fread(bytes, 1, *size, file) != *size) {
+    free(bytes);
+    bytes = NULL;
+  }
+  fclose(file);
+
+  return bytes;
+}
+
+static const cig_snapshot_record* load(const char *path, void **bytes, size_t *count) {
+  size_t size;
+  const cig_snapshot_record *records = NULL;
+
+  if ((*bytes = read_file(path, &size))) {
+    records = cig_snapshot_records(*bytes, size, count);
+  }
+  if (!records) {
+    fprintf(stderr, "%s is not a layout snapshot of version %d\n", path, CIG_SNAPSHOT_VERSION);
+  }
+
+  return records;
+}
+
+static void print_rect(const char *name, cig_r a, cig_r b) {
+  if (memcmp(&a, &b, sizeof(cig_r))) {
+    printf("  %s: (%d, %d, %d, %d) -> (%d, %d, %d, %d)\n", name, a.x, a.y, a.w, a.h, b.x, b.y, b.w, b.h);
+  }
+}
+
+static void print_difference(unsigned int tick, size_t index, const cig_snapshot_record *a, const cig_snapshot_record *b) {
+  printf("tick %u, frame %zu, id %llx:\n", tick, index, (unsigned long long)a->id);
+
+  if (a->id != b->id) {
+    printf("  id: %llx -> %llx\n", (unsigned long long)a->id, (unsigned long long)b->id);
+  }
+  if (a->parent != b->parent) {
+    printf("  parent: %llx -> %llx\n", (unsigned long long)a->parent, (unsigned long long)b->parent);
+  }
+  if (a->depth != b->depth) {
+    printf("  depth: %u -> %u\n", a->depth, b->depth);
+  }
+  print_rect("rect", a->rect, b->rect);
+  print_rect("clipped_rect", a->clipped_rect, b->clipped_rect);
+  print_rect("absolute_rect", a->absolute_rect, b->absolute_rect);
+  print_rect("absolute_clipped_rect", a->absolute_clipped_rect, b->absolute_clipped_rect);
+  print_rect("content_rect", a->content_rect, b->content_rect);
+  if (memcmp(&a->insets, &b->insets, sizeof(cig_i))) {
+    printf("  insets: (%d, %d, %d, %d) -> (%d, %d, %d, %d)\n",
+      a->insets.left, a->insets.top, a->insets.right, a->insets.bottom,
+      b->insets.left, b->insets.top, b->insets.right, b->insets.bottom);
+  }
+  if (a->flags != b->flags) {
+    printf("  flags: %02x -> %02x\n", a->flags, b->flags);
+  }
+  if (a->visibility != b->visibility) {
+    printf("  visibility: %u -> %u\n", a->visibility, b->visibility);
+  }
+}
+
+/*  Index of the tick record that ends the tick starting at `start` */
+static size_t tick_end(const cig_snapshot_record *records, size_t count, size_t start) {
+  while (start < count && records[start].kind != CIG_SNAPSHOT_TICK) {
+    start++;
+  }
+  return start;
+}
+
+int main(int argc, const char *argv[]) {
+  int i = 1, max_differences = DEFAULT_MAX_DIFFERENCES, differences = 0, missing = 0;
+  void *bytes_a, *bytes_b;
+  size_t count_a, count_b, a = 0, b = 0, j;
+  unsigned int tick = 0;
+
+  if (argc > 2 && !strcmp(argv[1], "-n")) {
+    max_differences = atoi(argv[2]);
+    i = 3;
+  }
+
+  if (argc - i != 2) {
+    fprintf(stderr, "Usage: %s [-n max differences] a.cigs b.cigs\n", argv[0]);
+    return 2;
+  }
+
+  const cig_snapshot_record *records_a = load(argv[i], &bytes_a, &count_a);
+  const cig_snapshot_record *records_b = load(argv[i + 1], &bytes_b, &count_b);
+
+  if (!records_a || !records_b) {
+    return 2;
+  }
+
+  /*  Ticks are compared pairwise, so one extra frame doesn't shift the rest
+      of the session out of alignment */
+  while (a < count_a && b < count_b) {
+    const size_t end_a = tick_end(records_a, count_a, a);
+    const size_t end_b = tick_end(records_b, count_b, b);
+    const size_t frames_a = end_a - a, frames_b = end_b - b;
+    const bool report = differences < max_differences;
+    bool differs = frames_a != frames_b;
+
+    if (differs && report) {
+      printf("tick %u: %zu frames -> %zu frames\n", tick, frames_a, frames_b);
+    }
+
+    /*  Only the first differing frame, the rest usually follows from it */
+    for (j = 0; j < frames_a && j < frames_b; ++j) {
+      if (memcmp(&records_a[a + j], &records_b[b + j], sizeof(cig_snapshot_record))) {
+        if (report) {
+          print_difference(tick, j, &records_a[a + j], &records_b[b + j]);
+        }
+        differs = true;
+        break;
+      }
+    }
+
+    differences += differs;
+    a = end_a + 1;
+    b = end_b + 1;
+    tick++;
+  }
+
+  /*  Remaining ticks of the longer session */
+  const char *longer = argv[a < count_a ? i : i + 1];
+
+  for (; a < count_a; a = tick_end(records_a, count_a, a) + 1) { missing++; }
+  for (; b < count_b; b = tick_end(records_b, count_b, b) + 1) { missing++; }
+
+  if (differences > max_differences) {
+    printf("... %d more\n", differences - max_differences);
+  }
+
+  if (missing) {
+    printf("%d ticks are only in %s\n", missing, longer);
+  }
+
+  if (differences || missing) {
+    printf("%d of %u ticks differ\n", differences, tick);
+  } else {
+    printf("layouts are identical (%u ticks)\n", tick);
+  }
+
+  free(bytes_a);
+  free(bytes_b);
+
+  return differences || missing ? 1 : 0;
+}